@@ -0,0 +1,19 @@
+// Stand-in for a web browser while `pebble emu-app-config` runs (set as $BROWSER): instead of
+// rendering bench/config.html, answer its return_to URL with the settings in $BENCH_SETTINGS.
+var http = require('http');
+var url = require('url');
+
+var configUrl = url.parse(process.argv[2], true);
+var returnTo = configUrl.query.return_to;
+if (!returnTo) {
+  console.error('No return_to in ' + process.argv[2]);
+  process.exit(1);
+}
+
+http.get(returnTo + encodeURIComponent(process.env.BENCH_SETTINGS), function (res) {
+  res.resume();
+  res.on('end', function () { process.exit(res.statusCode < 400 ? 0 : 1); });
+}).on('error', function (err) {
+  console.error('Could not return settings: ' + err);
+  process.exit(1);
+});
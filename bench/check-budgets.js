@@ -0,0 +1,82 @@
+// Check benchmark results against bench/budgets.json; exits non-zero when any figure is over.
+//
+//   node bench/check-budgets.js [build/bench/results.json] [--baseline]
+//
+// --baseline rewrites the budgets from the results instead, with BASELINE_HEADROOM to spare
+// (counts that must stay zero stay zero).
+var fs = require('fs');
+var path = require('path');
+
+var BUDGETS_FILE = path.join(__dirname, 'budgets.json');
+var DEFAULT_RESULTS = path.join(__dirname, '..', 'build', 'bench', 'results.json');
+var BASELINE_HEADROOM = 1.25;
+
+function budgetsFor(budgets, platform) {
+  var limits = {};
+  var overrides = (budgets.platforms || {})[platform] || {};
+  Object.keys(budgets.default).forEach(function (name) { limits[name] = budgets.default[name]; });
+  Object.keys(overrides).forEach(function (name) { limits[name] = overrides[name]; });
+  return limits;
+}
+
+// Returns the failures, one line each, and prints a table of every figure
+function check(results, budgets) {
+  var failures = [];
+  Object.keys(results.platforms).forEach(function (platform) {
+    var figures = results.platforms[platform];
+    var limits = budgetsFor(budgets, platform);
+    if (figures.error) {
+      console.log(platform + '\n  FAIL no figures: ' + figures.error);
+      failures.push(platform + ' did not finish: ' + figures.error);
+      return;
+    }
+    console.log(platform);
+    Object.keys(limits).forEach(function (name) {
+      var value = figures[name];
+      var over = value === undefined || value === null || value > limits[name];
+      console.log('  ' + (over ? 'FAIL' : 'ok  ') + ' ' + name + ': ' +
+        (value === undefined ? 'missing' : value) + ' (budget ' + limits[name] + ')');
+      if (over) failures.push(platform + ' ' + name + ' ' + value + ' > ' + limits[name]);
+    });
+  });
+  return failures;
+}
+
+function baseline(results, budgets) {
+  var worst = {};
+  Object.keys(results.platforms).forEach(function (platform) {
+    var figures = results.platforms[platform];
+    Object.keys(budgets.default).forEach(function (name) {
+      if (typeof figures[name] === 'number') worst[name] = Math.max(worst[name] || 0, figures[name]);
+    });
+  });
+  var rounded = {};
+  Object.keys(budgets.default).forEach(function (name) {
+    var value = worst[name] || 0;
+    rounded[name] = value === 0 ? 0 : +(value * BASELINE_HEADROOM).toPrecision(2);
+  });
+  return { _comment: budgets._comment, default: rounded, platforms: {} };
+}
+
+module.exports = { check: check, budgetsFor: budgetsFor };
+
+if (require.main === module) {
+  var args = process.argv.slice(2);
+  var rebaseline = args.indexOf('--baseline') !== -1;
+  var resultsFile = args.filter(function (arg) { return arg.indexOf('--') !== 0; })[0] || DEFAULT_RESULTS;
+  var results = JSON.parse(fs.readFileSync(resultsFile, 'utf8'));
+  var budgets = JSON.parse(fs.readFileSync(BUDGETS_FILE, 'utf8'));
+
+  if (rebaseline) {
+    fs.writeFileSync(BUDGETS_FILE, JSON.stringify(baseline(results, budgets), null, 2) + '\n');
+    console.log('Budgets rewritten from ' + resultsFile);
+    process.exit(0);
+  }
+
+  var failures = check(results, budgets);
+  if (failures.length > 0) {
+    console.error('\nOver budget:\n  ' + failures.join('\n  '));
+    process.exit(1);
+  }
+  console.log('\nAll figures within budget');
+}
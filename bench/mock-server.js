@@ -0,0 +1,173 @@
+// Mock W&B GraphQL backend for the benchmarks: replays a fixture file with configurable latency.
+//
+//   node bench/mock-server.js [--port 8765] [--latency 150] [--jitter 50] [--seed 1]
+//                             [--fixture bench/fixtures/default.json]
+//
+// Answers the operations PebbleKit JS sends (Viewer, Projects, Runs, MetricNames, RunMetrics)
+// from the fixture, and counts requests per operation for the benchmark report.
+var fs = require('fs');
+var http = require('http');
+var path = require('path');
+
+var DEFAULT_FIXTURE = path.join(__dirname, 'fixtures', 'default.json');
+
+// Deterministic jitter, so runs with the same seed see the same latencies
+function seededRandom(seed) {
+  var state = seed >>> 0;
+  return function () {
+    state = (state + 0x6D2B79F5) >>> 0;
+    var t = state;
+    t = Math.imul(t ^ (t >>> 15), t | 1);
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+  };
+}
+
+function operationName(query) {
+  var match = /^\s*query\s+(\w+)/.exec(query || '');
+  return match ? match[1] : 'anonymous';
+}
+
+// Recorded data of a run, or the fixture's '*' entry for runs without their own
+function runData(fixture, entity, project, runName) {
+  var runs = fixture.runData || {};
+  return runs[entity + '/' + project + '/' + runName] || runs['*'] || null;
+}
+
+// `samples` evenly spaced rows carrying the metric, like a sampledHistory spec
+function sampleHistory(rows, spec) {
+  var keys = spec.keys || [];
+  var metric = keys[keys.length - 1];
+  var carrying = rows.filter(function (row) { return row[metric] !== undefined && row[metric] !== null; });
+  var samples = spec.samples || carrying.length;
+  var picked = carrying;
+  if (carrying.length > samples) {
+    picked = [];
+    for (var i = 0; i < samples; i++) {
+      picked.push(carrying[Math.round(i * (carrying.length - 1) / Math.max(samples - 1, 1))]);
+    }
+  }
+  return picked.map(function (row) {
+    var out = {};
+    keys.forEach(function (key) { out[key] = row[key]; });
+    return out;
+  });
+}
+
+// Runs pages are addressed by offset; the cursor is the offset of the next page
+function runsPage(fixture, query, variables) {
+  var match = /runs\(first:\s*(\d+)/.exec(query);
+  var pageSize = match ? +match[1] : 5;
+  var data = {};
+
+  for (var i = 0; variables['e' + i] !== undefined; i++) {
+    var owner = variables['e' + i] + '/' + variables['n' + i];
+    var all = (fixture.runs || {})[owner];
+    if (!all) {
+      data['p' + i] = null;
+      continue;
+    }
+    var start = variables['a' + i] ? +variables['a' + i] : 0;
+    var end = Math.min(start + pageSize, all.length);
+    data['p' + i] = {
+      runs: {
+        edges: all.slice(start, end).map(function (run) { return { node: run }; }),
+        pageInfo: { endCursor: String(end), hasNextPage: end < all.length }
+      }
+    };
+  }
+  return data;
+}
+
+function respond(fixture, op, query, variables) {
+  variables = variables || {};
+  switch (op) {
+    case 'Viewer':
+      return { viewer: fixture.viewer };
+    case 'Projects':
+      return {
+        models: {
+          edges: (fixture.projects || []).filter(function (project) {
+            return project.entity === variables.entity;
+          }).map(function (project) {
+            return { node: { name: project.name, entityName: project.entity } };
+          })
+        }
+      };
+    case 'Runs':
+      return runsPage(fixture, query, variables);
+    case 'MetricNames':
+    case 'RunMetrics': {
+      var run = runData(fixture, variables.entity, variables.project, variables.runName);
+      if (!run) return { project: { run: null } };
+      var node = { summaryMetrics: JSON.stringify(run.summary) };
+      if (op === 'MetricNames') {
+        var keys = {};
+        Object.keys(run.summary).forEach(function (key) { keys[key] = {}; });
+        node.historyKeys = { keys: keys };
+      } else {
+        node.sampledHistory = (variables.specs || []).map(function (spec) {
+          return sampleHistory(run.history || [], JSON.parse(spec));
+        });
+      }
+      return { project: { run: node } };
+    }
+    default:
+      return null;
+  }
+}
+
+// Start the server; calls back with { server, port, requests } once it listens.
+// `requests` counts handled requests by operation name.
+function start(options, callback) {
+  var fixture = JSON.parse(fs.readFileSync(options.fixture || DEFAULT_FIXTURE, 'utf8'));
+  var latency = options.latency !== undefined ? options.latency : 150;
+  var jitter = options.jitter !== undefined ? options.jitter : 50;
+  var random = seededRandom(options.seed !== undefined ? options.seed : 1);
+  var requests = {};
+
+  var server = http.createServer(function (req, res) {
+    var body = '';
+    req.on('data', function (chunk) { body += chunk; });
+    req.on('end', function () {
+      var delay = latency + Math.round(jitter * random());
+      var request;
+      try {
+        request = JSON.parse(body);
+      } catch (e) {
+        request = {};
+      }
+      var op = operationName(request.query);
+      requests[op] = (requests[op] || 0) + 1;
+
+      var data = respond(fixture, op, request.query || '', request.variables);
+      var status = data ? 200 : 400;
+      var payload = data ? { data: data } : { errors: [{ message: 'Unknown operation ' + op }] };
+      setTimeout(function () {
+        res.writeHead(status, { 'Content-Type': 'application/json' });
+        res.end(JSON.stringify(payload));
+      }, delay);
+    });
+  });
+
+  server.listen(options.port || 8765, function () {
+    callback({ server: server, port: server.address().port, requests: requests });
+  });
+}
+
+module.exports = { start: start, sampleHistory: sampleHistory };
+
+function parseArgs(argv) {
+  var options = {};
+  for (var i = 0; i < argv.length; i += 2) {
+    var name = argv[i].replace(/^--/, '');
+    options[name] = name === 'fixture' ? argv[i + 1] : +argv[i + 1];
+  }
+  return options;
+}
+
+if (require.main === module) {
+  start(parseArgs(process.argv.slice(2)), function (mock) {
+    console.log('Mock GraphQL server on http://localhost:' + mock.port + '/graphql');
+  });
+}
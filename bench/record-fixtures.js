@@ -0,0 +1,161 @@
+// Record a benchmark fixture from a real W&B account, in the format bench/mock-server.js replays.
+//
+//   WANDB_API_KEY=... node bench/record-fixtures.js [--out bench/fixtures/recorded.json]
+//                     [--base-url https://api.wandb.ai/graphql] [--projects 3] [--runs 24]
+//                     [--history-runs 2]
+//
+// Projects and runs are kept in the order the API returns them. Full summaries and sampled
+// histories are recorded for the first --history-runs runs; the first of them also serves as
+// the '*' entry for every other run.
+var fs = require('fs');
+var path = require('path');
+var url = require('url');
+
+var HISTORY_SAMPLES = 500;
+
+function parseArgs(argv) {
+  var options = {
+    out: path.join(__dirname, 'fixtures', 'recorded.json'),
+    'base-url': 'https://api.wandb.ai/graphql',
+    projects: 3,
+    runs: 24,
+    'history-runs': 2
+  };
+  for (var i = 0; i < argv.length; i += 2) {
+    var name = argv[i].replace(/^--/, '');
+    options[name] = typeof options[name] === 'number' ? +argv[i + 1] : argv[i + 1];
+  }
+  return options;
+}
+
+function graphql(options, query, variables, callback) {
+  var endpoint = url.parse(options['base-url']);
+  var transport = require(endpoint.protocol === 'http:' ? 'http' : 'https');
+  var body = JSON.stringify({ query: query, variables: variables });
+  var req = transport.request({
+    hostname: endpoint.hostname,
+    port: endpoint.port,
+    path: endpoint.path,
+    method: 'POST',
+    headers: {
+      'Content-Type': 'application/json',
+      'Content-Length': Buffer.byteLength(body),
+      'Authorization': 'Basic ' + Buffer.from('api:' + options.apiKey).toString('base64')
+    }
+  }, function (res) {
+    var text = '';
+    res.on('data', function (chunk) { text += chunk; });
+    res.on('end', function () {
+      var response;
+      try {
+        response = JSON.parse(text);
+      } catch (e) {
+        return callback('HTTP ' + res.statusCode + ': ' + text.slice(0, 200));
+      }
+      if (response.errors) return callback(JSON.stringify(response.errors));
+      callback(null, response.data);
+    });
+  });
+  req.on('error', function (err) { callback(String(err)); });
+  req.end(body);
+}
+
+// Summary and history rows (merged by _step) of one run
+function recordRun(options, entity, project, runName, callback) {
+  var namesQuery = 'query MetricNames($entity: String!, $project: String!, $runName: String!) { ' +
+    'project(name: $project, entityName: $entity) { run(name: $runName) { summaryMetrics } } }';
+  graphql(options, namesQuery, { entity: entity, project: project, runName: runName }, function (err, data) {
+    if (err) return callback(err);
+    var summary = JSON.parse(data.project.run.summaryMetrics);
+    var keys = Object.keys(summary).filter(function (key) {
+      return key.charAt(0) !== '_' && typeof summary[key] === 'number';
+    });
+    var specs = keys.map(function (key) {
+      return JSON.stringify({ keys: ['_step', key], samples: HISTORY_SAMPLES });
+    });
+    var historyQuery = 'query RunMetrics($entity: String!, $project: String!, $runName: String!, $specs: [JSONString!]!) { ' +
+      'project(name: $project, entityName: $entity) { run(name: $runName) { sampledHistory(specs: $specs) } } }';
+    graphql(options, historyQuery, { entity: entity, project: project, runName: runName, specs: specs }, function (err, data) {
+      if (err) return callback(err);
+      var byStep = {};
+      (data.project.run.sampledHistory || []).forEach(function (rows, k) {
+        rows.forEach(function (row) {
+          var merged = byStep[row._step] = byStep[row._step] || { _step: row._step };
+          merged[keys[k]] = row[keys[k]];
+        });
+      });
+      var history = Object.keys(byStep).map(Number).sort(function (a, b) { return a - b; })
+        .map(function (step) { return byStep[step]; });
+      var kept = { _step: summary._step, _runtime: summary._runtime };
+      keys.forEach(function (key) { kept[key] = summary[key]; });
+      callback(null, { summary: kept, history: history });
+    });
+  });
+}
+
+function record(options, done) {
+  var fixture = { viewer: null, projects: [], runs: {}, runData: {} };
+
+  graphql(options, 'query Viewer { viewer { entity username } }', null, function (err, data) {
+    if (err) return done(err);
+    fixture.viewer = data.viewer;
+
+    var projectsQuery = 'query Projects($entity: String!) { models(entityName: $entity, first: ' +
+      options.projects + ') { edges { node { name entityName } } } }';
+    graphql(options, projectsQuery, { entity: data.viewer.entity }, function (err, data) {
+      if (err) return done(err);
+      fixture.projects = data.models.edges.map(function (edge) {
+        return { entity: edge.node.entityName, name: edge.node.name };
+      });
+
+      var perProject = Math.ceil(options.runs / Math.max(fixture.projects.length, 1));
+      var pending = fixture.projects.slice();
+      var recorded = [];
+
+      (function nextProject() {
+        var project = pending.shift();
+        if (!project) return recordHistories();
+        var runsQuery = 'query Runs($e: String!, $n: String!) { project(name: $n, entityName: $e) { ' +
+          'runs(first: ' + perProject + ', order: "-createdAt") { edges { node { name displayName state createdAt } } } } }';
+        graphql(options, runsQuery, { e: project.entity, n: project.name }, function (err, data) {
+          if (err) return done(err);
+          var runs = data.project ? data.project.runs.edges.map(function (edge) { return edge.node; }) : [];
+          fixture.runs[project.entity + '/' + project.name] = runs;
+          runs.forEach(function (run) { recorded.push({ entity: project.entity, project: project.name, run: run }); });
+          nextProject();
+        });
+      })();
+
+      function recordHistories() {
+        var withHistory = recorded.slice(0, options['history-runs']);
+        (function nextRun() {
+          var item = withHistory.shift();
+          if (!item) return done(null, fixture);
+          recordRun(options, item.entity, item.project, item.run.name, function (err, data) {
+            if (err) return done(err);
+            fixture.runData[item.entity + '/' + item.project + '/' + item.run.name] = data;
+            if (!fixture.runData['*']) fixture.runData['*'] = data;
+            nextRun();
+          });
+        })();
+      }
+    });
+  });
+}
+
+if (require.main === module) {
+  var options = parseArgs(process.argv.slice(2));
+  options.apiKey = process.env.WANDB_API_KEY;
+  if (!options.apiKey) {
+    console.error('Set WANDB_API_KEY to the account to record');
+    process.exit(2);
+  }
+  record(options, function (err, fixture) {
+    if (err) {
+      console.error('Recording failed: ' + err);
+      process.exit(1);
+    }
+    fs.writeFileSync(options.out, JSON.stringify(fixture, null, 2) + '\n');
+    console.log('Recorded ' + Object.keys(fixture.runData).length + ' run histories to ' + options.out);
+  });
+}
@@ -0,0 +1,271 @@
+// Emulator benchmarks: cold start, scrolling through 30 metrics and a scrub session on every
+// platform in package.json's targetPlatforms, against the mock GraphQL server.
+//
+//   node bench/run.js [--platform basalt] [--latency 150] [--jitter 50] [--seed 1]
+//                     [--fixture bench/fixtures/default.json] [--no-build] [--no-check]
+//
+// Figures come from the watch's DIAGNOSTICS export (see diag_export_fields() in
+// wandb-for-pebble.c), read from `pebble logs`, plus the mock server's request count.
+// They are written to build/bench/results.json and checked against bench/budgets.json.
+var childProcess = require('child_process');
+var fs = require('fs');
+var path = require('path');
+var mockServer = require('./mock-server');
+var budgetCheck = require('./check-budgets');
+
+var ROOT = path.join(__dirname, '..');
+var RESULTS_FILE = path.join(ROOT, 'build', 'bench', 'results.json');
+var MOCK_PORT = 8765;
+
+// Script timing, generous enough for the slower emulators
+var BOOT_TIMEOUT_MS = 120000;
+var STEP_TIMEOUT_MS = 30000;
+var SETTLE_MS = 2000;
+var SCROLL_METRICS = 30;
+var SCROLL_INTERVAL_MS = 600;
+var SCRUB_HOLD_MS = 2000;
+var LONG_PRESS_MS = 1000;
+
+function parseArgs(argv) {
+  var options = { build: true, check: true };
+  for (var i = 0; i < argv.length; i++) {
+    var name = argv[i].replace(/^--/, '');
+    if (name === 'no-build') options.build = false;
+    else if (name === 'no-check') options.check = false;
+    else options[name] = argv[++i];
+  }
+  ['latency', 'jitter', 'seed'].forEach(function (name) {
+    if (options[name] !== undefined) options[name] = +options[name];
+  });
+  return options;
+}
+
+function pebble(args, env) {
+  console.log('$ pebble ' + args.join(' '));
+  var result = childProcess.spawnSync('pebble', args, {
+    cwd: ROOT,
+    stdio: 'inherit',
+    env: Object.assign({}, process.env, env || {})
+  });
+  if (result.error) throw result.error;
+  if (result.status !== 0) throw new Error('pebble ' + args[0] + ' exited with ' + result.status);
+}
+
+function button(platform, action, name, extra) {
+  pebble(['emu-button', '--emulator', platform, action, name].concat(extra || []));
+}
+
+// Follows `pebble logs` and resolves waits on lines matching a pattern
+function LogWatcher(platform) {
+  var self = this;
+  this.lines = [];
+  this.waiters = [];
+  this.child = childProcess.spawn('pebble', ['logs', '--emulator', platform], { cwd: ROOT });
+  var pending = '';
+  this.child.stdout.on('data', function (chunk) {
+    var parts = (pending + chunk).split('\n');
+    pending = parts.pop();
+    parts.forEach(function (line) { self.onLine(line); });
+  });
+}
+
+LogWatcher.prototype.onLine = function (line) {
+  this.lines.push(line);
+  this.waiters = this.waiters.filter(function (waiter) {
+    var match = waiter.pattern.exec(line);
+    if (!match) return true;
+    clearTimeout(waiter.timer);
+    waiter.callback(null, match);
+    return false;
+  });
+};
+
+// Calls back with the first match logged from now on
+LogWatcher.prototype.waitFor = function (pattern, timeoutMs, callback) {
+  var self = this;
+  var waiter = { pattern: pattern, callback: callback };
+  waiter.timer = setTimeout(function () {
+    self.waiters = self.waiters.filter(function (w) { return w !== waiter; });
+    callback(new Error('Timed out waiting for ' + pattern));
+  }, timeoutMs);
+  this.waiters.push(waiter);
+};
+
+LogWatcher.prototype.stop = function () {
+  this.child.kill();
+};
+
+// Run `steps` (function (next)) in order; `done(err)` after the last or the first failure
+function series(steps, done) {
+  (function next(err) {
+    if (err) return done(err);
+    var step = steps.shift();
+    if (!step) return done(null);
+    try {
+      step(next);
+    } catch (e) {
+      done(e);
+    }
+  })();
+}
+
+function sleep(ms) {
+  return function (next) { setTimeout(next, ms); };
+}
+
+// Figures of one platform from the watch's diagnostics and the mock's request counts
+function figures(report, requests) {
+  var shown = report.bufferHits + report.bufferMisses;
+  var total = 0;
+  Object.keys(requests).forEach(function (op) { total += requests[op]; });
+  return {
+    firstRowMs: report.firstRowMs,
+    openToMetricMs: report.openToMetricMs,
+    skeletonFramesPerScroll: shown > 0 ? +(report.skeletonFrames / shown).toFixed(2) : null,
+    bytesReceived: report.bytesReceived,
+    bytesSent: report.bytesSent,
+    graphqlRequests: total,
+    inboxDrops: report.inboxDrops,
+    outboxFailures: report.outboxFailures,
+    heapPeakBytes: report.heapPeakBytes,
+    requestsByOperation: JSON.parse(JSON.stringify(requests))
+  };
+}
+
+function benchPlatform(platform, mock, callback) {
+  var settings = JSON.stringify({
+    apiKey: { value: 'bench' },
+    baseUrl: { value: 'http://localhost:' + mock.port + '/graphql' },
+    refreshInterval: { value: '30000' },
+    timelinePins: { value: false }
+  });
+  var logs = null;
+  var report = null;
+
+  series([
+    // Cold: no watch cache, no phone cache, then settings pointing at the mock
+    function (next) {
+      pebble(['wipe']);
+      pebble(['install', '--emulator', platform]);
+      logs = new LogWatcher(platform);
+      pebble(['emu-app-config', '--emulator', platform, '--file', path.join(__dirname, 'config.html')], {
+        BROWSER: 'node ' + path.join(__dirname, 'browser.js') + ' %s',
+        BENCH_SETTINGS: settings
+      });
+      Object.keys(mock.requests).forEach(function (op) { delete mock.requests[op]; });
+      next();
+    },
+
+    // Cold start: relaunch with the settings and wait for the runs list
+    function (next) {
+      pebble(['install', '--emulator', platform]);
+      logs.waitFor(/Fetched \d+ runs/, BOOT_TIMEOUT_MS, function (err) { next(err); });
+    },
+    sleep(SETTLE_MS),
+
+    // Open the first run, then scroll through its metrics
+    function (next) {
+      button(platform, 'click', 'select');
+      next();
+    },
+    sleep(SETTLE_MS),
+    function (next) {
+      button(platform, 'click', 'down',
+        ['--repeat', String(SCROLL_METRICS - 1), '--interval', String(SCROLL_INTERVAL_MS)]);
+      next();
+    },
+    sleep(SETTLE_MS),
+
+    // Scrub back and forth through the history, then leave scrub mode
+    function (next) {
+      button(platform, 'click', 'select');
+      button(platform, 'push', 'up');
+      next();
+    },
+    sleep(SCRUB_HOLD_MS),
+    function (next) {
+      button(platform, 'release', 'up');
+      button(platform, 'push', 'down');
+      next();
+    },
+    sleep(SCRUB_HOLD_MS / 2),
+    function (next) {
+      button(platform, 'release', 'down');
+      button(platform, 'click', 'select');
+      next();
+    },
+    sleep(SETTLE_MS),
+
+    // Back in the runs menu, long-press for diagnostics and send them to the phone log
+    function (next) {
+      button(platform, 'click', 'back');
+      button(platform, 'click', 'select', ['--duration', String(LONG_PRESS_MS)]);
+      logs.waitFor(/Watch diagnostics: (\{.*\})/, STEP_TIMEOUT_MS, function (err, match) {
+        if (!err) report = JSON.parse(match[1]);
+        next(err);
+      });
+      button(platform, 'click', 'select');
+    }
+  ], function (err) {
+    if (logs) logs.stop();
+    try {
+      pebble(['kill']);
+    } catch (e) {
+      console.log('Could not stop the emulator: ' + e.message);
+    }
+    if (err) return callback(err);
+    callback(null, figures(report, mock.requests));
+  });
+}
+
+function main() {
+  var options = parseArgs(process.argv.slice(2));
+  var pkg = JSON.parse(fs.readFileSync(path.join(ROOT, 'package.json'), 'utf8'));
+  var platforms = options.platform ? [options.platform] : pkg.pebble.targetPlatforms;
+
+  if (options.build) pebble(['build']);
+
+  mockServer.start({
+    port: MOCK_PORT,
+    latency: options.latency,
+    jitter: options.jitter,
+    seed: options.seed,
+    fixture: options.fixture
+  }, function (mock) {
+    var results = {
+      recordedAt: new Date().toISOString(),
+      latencyMs: options.latency !== undefined ? options.latency : 150,
+      platforms: {}
+    };
+    var failed = false;
+
+    series(platforms.map(function (platform) {
+      return function (next) {
+        console.log('\n== ' + platform);
+        benchPlatform(platform, mock, function (err, result) {
+          if (err) {
+            console.error(platform + ' failed: ' + err.message);
+            failed = true;
+            results.platforms[platform] = { error: err.message };
+          } else {
+            results.platforms[platform] = result;
+          }
+          next();
+        });
+      };
+    }), function () {
+      mock.server.close();
+      fs.mkdirSync(path.dirname(RESULTS_FILE), { recursive: true });
+      fs.writeFileSync(RESULTS_FILE, JSON.stringify(results, null, 2) + '\n');
+      console.log('\nResults written to ' + path.relative(ROOT, RESULTS_FILE) + '\n');
+
+      if (options.check) {
+        var budgets = JSON.parse(fs.readFileSync(path.join(__dirname, 'budgets.json'), 'utf8'));
+        if (budgetCheck.check(results, budgets).length > 0) failed = true;
+      }
+      process.exit(failed ? 1 : 0);
+    });
+  });
+}
+
+main();
@@ -1,15 +1,82 @@
 #include <pebble.h>
 
+// Capacity profile: how deep the caches are on each platform. Picked by platform below, or
+// forced for every platform with `pebble build -- --capacity-profile=<small|medium|large>`
+// (see wscript). CAPACITY_RAM_BUDGET and PERSIST_CACHE_BUDGET are checked at compile time
+// against what the profile sizes (see "Capacity budgets"), so an oversized cache fails the build.
+#if !defined(CAPACITY_PROFILE_SMALL) && !defined(CAPACITY_PROFILE_MEDIUM) && !defined(CAPACITY_PROFILE_LARGE)
+  #if defined(PBL_PLATFORM_EMERY)
+    #define CAPACITY_PROFILE_LARGE
+  #elif defined(PBL_PLATFORM_DIORITE) || defined(PBL_PLATFORM_FLINT)
+    #define CAPACITY_PROFILE_SMALL
+  #else
+    #define CAPACITY_PROFILE_MEDIUM
+  #endif
+#endif
+
+// Per profile:
+//   MAX_WANDB_RUNS            Window of the phone's runs list kept around the menu selection
+//   MAX_RUN_PROJECTS          Distinct "entity/project" strings among the windowed runs
+//   RUN_STRINGS_SIZE          Shared table of run and project names
+//   MAX_GRAPH_HISTORY_POINTS  History per metric; the phone downsamples to what the graph can show
+//   METRIC_BUFFER_MAX_SLOTS   Most metrics buffered at once
+//   CACHE_MAX_SLOTS           Metric slots kept in the warm-start cache
+//   APP_MESSAGE_INBOX_CAP     Upper bound on the inbox, whatever the platform allows
+//   CAPACITY_RAM_BUDGET       Bytes the profile-sized state may take, static and heap together
+#if defined(CAPACITY_PROFILE_LARGE)
+  #define MAX_WANDB_RUNS 96
+  #define MAX_RUN_PROJECTS 24
+  #define RUN_STRINGS_SIZE 1536
+  #define MAX_GRAPH_HISTORY_POINTS 48
+  #define METRIC_BUFFER_MAX_SLOTS 16
+  #define CACHE_MAX_SLOTS 3
+  #define APP_MESSAGE_INBOX_CAP 4096
+  #define CAPACITY_RAM_BUDGET (32 * 1024)
+#elif defined(CAPACITY_PROFILE_SMALL)
+  #define MAX_WANDB_RUNS 48
+  #define MAX_RUN_PROJECTS 16
+  #define RUN_STRINGS_SIZE 1024
+  #define MAX_GRAPH_HISTORY_POINTS 24
+  #define METRIC_BUFFER_MAX_SLOTS 5
+  #define CACHE_MAX_SLOTS 4
+  #define APP_MESSAGE_INBOX_CAP 2048
+  #define CAPACITY_RAM_BUDGET (12 * 1024)
+#else
+  #define MAX_WANDB_RUNS 48
+  #define MAX_RUN_PROJECTS 16
+  #define RUN_STRINGS_SIZE 1024
+  #define MAX_GRAPH_HISTORY_POINTS 32
+  #define METRIC_BUFFER_MAX_SLOTS 10
+  #define CACHE_MAX_SLOTS 4
+  #define APP_MESSAGE_INBOX_CAP 2048
+  #define CAPACITY_RAM_BUDGET (16 * 1024)
+#endif
+
 // Data storage limits
-#define MAX_WANDB_RUNS 10
 #define MAX_RUN_NAME_CHARS 32
 #define MAX_METRIC_VALUE_CHARS 16
-#define MAX_GRAPH_HISTORY_POINTS 20
-#define METRIC_SLIDING_BUFFER_SLOTS 3
+
+// Metric buffer sizing: slots are allocated at startup from a share of the free heap
+#define METRIC_BUFFER_MIN_SLOTS 3
+#define METRIC_BUFFER_HEAP_DIVISOR 8   // Use at most 1/8 of the heap free at startup
+
+// The next page of runs is requested when the selection is this close to either end of the window
+#define RUNS_PAGE_MARGIN 3
+
+// Prefetch window around the current page, skewed toward the scroll direction
+#define PREFETCH_WINDOW_MAX 5
+#define PREFETCH_BEHIND 1
 
 // Layout constants
 #define CONTENT_LEFT_PADDING 10
 #define STATUS_BAR_HEIGHT 16
+#if defined(PBL_ROUND)
+  #define DETAIL_PADDING 30
+  #define DETAIL_GRAPH_INSET 10
+#else
+  #define DETAIL_PADDING CONTENT_LEFT_PADDING
+  #define DETAIL_GRAPH_INSET 0
+#endif
 
 // Scroll transition animation
 #define SCROLL_ANIM_DURATION_MS 200
@@ -19,6 +86,7 @@
 #define GRAPH_OUTER_MARGIN 5
 #define GRAPH_CURRENT_INDICATOR_SIZE 10
 #define GRAPH_DATA_POINT_SIZE 3
+#define GRAPH_MIN_POINT_SPACING 4   // Pixels between samples; denser histories add no detail
 
 // Scrub mode (history navigation) timing
 #define SCRUB_POSITION_SCALE 1000
@@ -28,14 +96,63 @@
 
 // Network request timing
 #define METRIC_REQUEST_DEBOUNCE_MS 500
-#define ADJACENT_METRIC_STAGGER_MS 300
-#define METRIC_AUTO_REFRESH_MS 30000
+#define RUN_PREFETCH_DEBOUNCE_MS 400   // Highlight dwell before the phone is hinted to prefetch
+
+// Live updates are paused below this charge (unless charging)
+#define LIVE_UPDATES_MIN_BATTERY_PERCENT 20
+
+// Diagnostics
+#define DIAG_MAX_PENDING_TIMINGS 4    // Metric requests timed at once; the oldest is overwritten
+#define DIAG_REFRESH_MS 1000          // Diagnostics window redraw interval
+#define DIAG_TEXT_MAX_HEIGHT 2000     // Layout height the text is measured in before fitting
+#define DIAG_TEXT_BOTTOM_MARGIN 8
+#define DIAG_EXPORT_FIELDS 16         // uint32 fields in a DIAGNOSTICS export, see diag_export_fields
+#define DIAG_TRACE_CHARS 256          // Phone's request trace summary (TRACE_SUMMARY_MAX_CHARS + 1)
+
+// Overview grid
+#define MAX_OVERVIEW_TILES 64         // Metrics asked for; the tile array is sized to what the phone sends
+#define OVERVIEW_NAME_CHARS 20        // OVERVIEW_NAME_BYTES + 1 on the phone
+#define OVERVIEW_SPARK_POINTS 16      // Must match OVERVIEW_SPARK_POINTS on the phone
+#define OVERVIEW_SPARK_LEVELS 15      // 4-bit sample levels
+#define OVERVIEW_COLUMNS PBL_IF_ROUND_ELSE(1, 2)
+#define OVERVIEW_TILE_HEIGHT 50
+#define OVERVIEW_TILE_PADDING 3
+#define OVERVIEW_SPARK_HEIGHT 14
+
+// Outbound request queue
+#define OUTBOUND_QUEUE_CAPACITY 6
+#define OUTBOUND_MAX_ATTEMPTS 4
+#define OUTBOUND_RETRY_BASE_MS 250    // Doubled on every failed attempt
+
+// AppMessage sizing
+#define METRIC_BATCH_MAX 8            // Must match the METRIC_*[N] array keys in package.json
+#define APP_MESSAGE_OUTBOX_SIZE 96    // Largest message is the DIAGNOSTICS export
 
 // Persistent storage keys
-#define PERSIST_KEY_REFRESH_INTERVAL 1
+#define PERSIST_KEY_CACHE_HEADER 2
+#define PERSIST_KEY_CACHE_RUNS_BASE 16    // Runs blob, chunked over consecutive keys
+#define PERSIST_KEY_CACHE_STRINGS_BASE 32 // Project table and string table, chunked likewise
+#define PERSIST_KEY_CACHE_SLOTS_BASE 48   // Metric slots, PERSIST_KEYS_PER_SLOT keys each
+
+// Warm-start cache layout version; bump when the cached records change meaning
+#define CACHE_FORMAT_VERSION 5
+#define PERSIST_CACHE_BUDGET (4096 - 256)   // The app's 4 KB of storage, less the other keys
 
 // Fixed-point arithmetic for value interpolation (4 decimal places)
 #define VALUE_INTERPOLATION_SCALE 10000
+#define MAX_VALUE_DECIMALS 4
+
+// METRIC_VALUE payload: uint8 decimal places, then the little-endian int64 fixed-point value.
+// A metric without a value sends only METRIC_VALUE_NONE.
+#define METRIC_VALUE_NONE 0xFF
+#define METRIC_VALUE_BYTES (1 + sizeof(int64_t))
+
+// METRIC_HISTORY wire formats, selected by the payload's first byte
+#define HISTORY_FORMAT_INT64 0    // Raw little-endian int64 fixed-point points
+#define HISTORY_FORMAT_Q8 1       // int64 min, int64 max, then uint8 samples over that range
+#define HISTORY_FORMAT_Q16 2      // int64 min, int64 max, then little-endian uint16 samples
+#define HISTORY_FORMAT_VARINT 3   // Zigzag varint deltas between consecutive points
+#define HISTORY_QUANTIZED_HEADER_BYTES 16   // min + max, after the format byte
 
 typedef enum {
   ScrollDirectionUp,
@@ -44,11 +161,56 @@ typedef enum {
 
 typedef struct {
   char name[MAX_RUN_NAME_CHARS];
-  char value[MAX_METRIC_VALUE_CHARS];
+  char value[MAX_METRIC_VALUE_CHARS];         // value_fixed formatted once on receipt, or "---"
+  int64_t value_fixed;                        // Current value, fixed-point like the history
+  uint8_t value_decimals;                     // Decimal places the value is shown with
+  bool has_value;
   int64_t history[MAX_GRAPH_HISTORY_POINTS];  // Fixed-point historical values (64-bit)
+  int32_t last_step;        // _step of the last point sent by the phone (-1 if unknown)
   uint8_t history_count;
+  bool has_live_point;      // Last history point is the appended current value, not a sample
 } WandbMetric;
 
+// Outbound request priorities, most urgent first
+typedef enum {
+  REQUEST_PRIORITY_CURRENT,     // Batch containing the metric on screen
+  REQUEST_PRIORITY_NEIGHBOURS,  // Prefetch of adjacent metrics only
+  REQUEST_PRIORITY_SUBSCRIPTION, // Which metrics the phone should keep pushing updates for
+  REQUEST_PRIORITY_HINT,        // Speculative, nothing waits on it
+} RequestPriority;
+
+// What an outbound request asks the phone for
+typedef enum {
+  REQUEST_KIND_METRICS,     // Fetch a range of metrics
+  REQUEST_KIND_SUBSCRIBE,   // Replace the phone's push subscription
+  REQUEST_KIND_RUNS_PAGE,   // Extend the runs window from run_index
+  REQUEST_KIND_DIAGNOSTICS, // Send the diagnostics counters to the phone's log
+  REQUEST_KIND_TRACE,       // Ask for the phone's request trace summary
+  REQUEST_KIND_OVERVIEW,    // Fetch sparkline tiles for up to `count` metrics of a run
+  REQUEST_KIND_PREFETCH,    // Hint that run_index is highlighted; the phone warms its caches
+} RequestKind;
+
+// A queued message to the phone, usually for a range of metrics
+typedef struct {
+  RequestPriority priority;
+  RequestKind kind;
+  uint16_t run_index;       // Position in the phone's runs list (first row wanted for RUNS_PAGE)
+  uint8_t first_index;
+  uint8_t count;            // 0 with SUBSCRIBE cancels the subscription
+  bool backward;            // RUNS_PAGE: rows before run_index rather than from it
+  int32_t base_step;        // Last _step held for first_index, for history deltas (-1 if none)
+  uint8_t attempts;
+} OutboundRequest;
+
+// Fixed-capacity queue drained one message at a time from the outbox callbacks
+typedef struct {
+  OutboundRequest items[OUTBOUND_QUEUE_CAPACITY];
+  uint8_t count;
+  bool in_flight;           // A message is in the outbox awaiting sent/failed
+  OutboundRequest sending;
+  AppTimer *retry_timer;
+} OutboundQueue;
+
 // Metric buffer slot states
 typedef enum {
   SLOT_EMPTY,
@@ -56,37 +218,106 @@ typedef enum {
   SLOT_READY
 } MetricSlotState;
 
+// Value range of a metric's history
+typedef struct {
+  int64_t min;
+  int64_t max;
+  int64_t range;
+} ValueRange;
+
+// History projected onto the graph layer, reused across redraws (e.g. every scrub frame)
+typedef struct {
+  GPoint points[MAX_GRAPH_HISTORY_POINTS];
+  ValueRange range;
+  GSize size;               // Graph bounds the points were projected for
+  bool valid;               // Cleared when new history lands
+} GraphGeometry;
+
 // A single buffer slot containing one metric and its metadata
 typedef struct {
   WandbMetric metric;
-  int8_t metric_id;         // Which metric index this is (-1 if empty)
+  GraphGeometry geometry;
+  int16_t metric_id;        // Which metric index (0-255) this is, -1 if empty
   MetricSlotState state;
+  bool stale;               // Restored from cache or left behind; shown but due for refresh
 } MetricBufferSlot;
 
-// The 3-slot sliding window buffer
+// Sliding window buffer, sized for the platform in metric_buffer_create()
 typedef struct {
-  MetricBufferSlot slots[METRIC_SLIDING_BUFFER_SLOTS];
+  MetricBufferSlot *slots;
+  uint8_t num_slots;
 } MetricBuffer;
 
 #define MAX_STATE_LENGTH 16
 
+// W&B run states; anything unrecognised is grouped under RUN_STATE_OTHER
+typedef enum {
+  RUN_STATE_RUNNING,
+  RUN_STATE_PENDING,
+  RUN_STATE_FINISHED,
+  RUN_STATE_CRASHED,
+  RUN_STATE_FAILED,
+  RUN_STATE_KILLED,
+  RUN_STATE_PREEMPTED,
+  RUN_STATE_OTHER,
+  RUN_STATE_REMOVED,      // Deleted on W&B; kept as a hidden row so later list indices stay put
+  RUN_STATE_COUNT
+} RunState;
+
+#define RUN_PROJECT_NONE 0xFF
+
+// Interned "entity/project" string, shared by every run of the project
 typedef struct {
-  char run_name[MAX_RUN_NAME_CHARS];
-  char project_name[MAX_RUN_NAME_CHARS];
-  char state[MAX_STATE_LENGTH];
+  uint16_t offset;        // Into WandbData.strings
+  uint8_t phone_id;       // The phone's ID for the project this session (RUN_PROJECT_NONE if unbound)
+  uint8_t refs;           // Runs using the entry; 0 means the entry is free
+} RunProject;
+
+typedef struct {
+  uint16_t name_offset;   // Run name, NUL-terminated in WandbData.strings
+  uint16_t list_index;    // Position in the phone's full runs list
+  uint8_t project;        // Index into WandbData.projects (RUN_PROJECT_NONE if unknown)
+  uint8_t state;          // RunState
   uint8_t total_metrics;  // Total number of metrics for this run
+  bool stale;             // Restored from cache, not yet confirmed by the phone
 } WandbRun;
 
-// App data (persistent)
+// Enough of a run to find it again after its record and strings have been rewritten
+typedef struct {
+  char run_name[MAX_RUN_NAME_CHARS];
+  char project_name[MAX_RUN_NAME_CHARS];
+  uint8_t total_metrics;
+} RunIdentity;
+
+// Runs menu section: one per state, in order of first appearance in the runs list
+typedef struct {
+  uint8_t state;          // RunState
+  uint8_t first_row;      // Offset of the section's runs in RunSectionIndex.run_indices
+  uint8_t num_rows;
+} RunSection;
+
+// Section/row -> run lookup for the menu, rebuilt whenever s_data.runs changes
+typedef struct {
+  RunSection sections[RUN_STATE_COUNT];
+  uint8_t num_sections;
+  uint8_t run_indices[MAX_WANDB_RUNS];
+} RunSectionIndex;
+
+// App data (persistent): a contiguous window of the runs list, in list order
 typedef struct {
   WandbRun runs[MAX_WANDB_RUNS];
+  RunProject projects[MAX_RUN_PROJECTS];
+  char strings[RUN_STRINGS_SIZE];   // Run and project names, packed back to back
+  uint16_t strings_used;
   uint8_t num_runs;
 } WandbData;
 
 // UI state (ephemeral)
 typedef struct {
   uint8_t selected_run_index;
+  uint16_t menu_list_index;   // List index of the run highlighted in the menu
   uint8_t current_metric_page;
+  int8_t scroll_delta;        // Direction of the last scroll (+1 down, -1 up), skews prefetch
   uint8_t graph_display_page;
   bool loading;
 } UIState;
@@ -98,6 +329,7 @@ typedef struct {
   StatusBarLayer *status_bar;
   TextLayer *loading_layer;
   AppTimer *loading_timer;
+  AppTimer *prefetch_timer; // Pending prefetch hint for the highlighted run
   bool loading;
 } MainWindowState;
 
@@ -107,6 +339,11 @@ typedef struct {
   TextLayer *value_layer;
   TextLayer *name_layer;
   Layer *graph_layer;
+  Layer *indicator_layer;       // Child of graph_layer; the only layer scrub animations dirty
+  GBitmap *graph_bitmap;        // Pre-rendered graph, blitted until data or scrub mode changes
+  int16_t graph_bitmap_metric;  // Metric ID the bitmap was rendered for
+  bool graph_bitmap_scrub;      // Rendered as scrub-mode dots rather than a line
+  bool graph_bitmap_valid;
   StatusBarLayer *status_bar;
   TextLayer *pagination_layer;
   GRect value_frame;
@@ -135,21 +372,191 @@ typedef struct {
 
 // Value animation state
 typedef struct {
-  int32_t from;
-  int32_t to;
-  int decimals;
+  int64_t from;
+  int64_t to;
+  uint8_t decimals;
   char buffer[MAX_METRIC_VALUE_CHARS];
 } ValueAnimState;
 
+// Send time of a metric request, matched against the METRIC_INDEX entries that answer it
+typedef struct {
+  uint32_t sent_ms;
+  uint8_t first_index;
+  uint8_t count;
+  bool active;
+} PendingTiming;
+
+// Performance counters for the diagnostics window (ephemeral)
+typedef struct {
+  PendingTiming pending[DIAG_MAX_PENDING_TIMINGS];
+  uint32_t latency_count;     // Metric requests answered
+  uint32_t latency_total_ms;
+  uint32_t latency_min_ms;
+  uint32_t latency_max_ms;
+  uint32_t latency_last_ms;
+  uint32_t buffer_hits;       // Scrolls onto a metric already loaded in s_metric_buffer
+  uint32_t buffer_misses;
+  uint32_t inbox_drops;
+  uint32_t outbox_failures;   // Failed send attempts, whether retried or not
+  uint32_t bytes_received;
+  uint32_t bytes_sent;
+  uint32_t heap_high_water;
+  uint32_t started_ms;        // App launch, for time to first run row
+  uint32_t first_row_ms;      // Launch to the first runs row from the phone (0 until then)
+  uint32_t detail_opened_ms;  // When a run was selected without buffered metrics (0 once shown)
+  uint32_t open_to_metric_ms; // Last time from selecting a run to its first metric showing
+  uint32_t skeleton_frames;   // Graph frames drawn as a loading skeleton
+} Diagnostics;
+
+// Diagnostics window state
+typedef struct {
+  Window *window;
+  StatusBarLayer *status_bar;
+  ScrollLayer *scroll_layer;
+  TextLayer *text_layer;
+  AppTimer *refresh_timer;
+  char phone_trace[DIAG_TRACE_CHARS];   // Latest TRACE_SUMMARY, per W&B operation and the BT hop
+  char text[DIAG_TRACE_CHARS + 384];
+} DiagnosticsWindowState;
+
+// One metric in the overview grid, as packed by packOverviewTile on the phone
+typedef struct {
+  char name[OVERVIEW_NAME_CHARS];
+  char value[MAX_METRIC_VALUE_CHARS];
+  uint8_t spark[OVERVIEW_SPARK_POINTS / 2];  // 4-bit levels, two per byte, high nibble first
+  uint8_t spark_count;
+  bool ready;               // Received; drawn as a skeleton until then
+} OverviewTile;
+
+// Overview window state; the tiles only exist while the window is open
+typedef struct {
+  Window *window;
+  StatusBarLayer *status_bar;
+  Layer *grid_layer;
+  OverviewTile *tiles;
+  uint8_t num_tiles;
+  bool counted;             // num_tiles is known (the first OVERVIEW_DATA arrived)
+  uint8_t selected;
+  uint8_t first_row;        // Topmost visible grid row
+} OverviewWindowState;
+
+// Warm-start cache header, stored under PERSIST_KEY_CACHE_HEADER
+typedef struct {
+  uint8_t version;
+  uint8_t num_runs;
+  uint16_t run_record_size;   // sizeof(WandbRun) when written, guards against layout changes
+  uint16_t slot_record_size;  // sizeof(WandbMetric) when written
+  uint16_t strings_used;      // Bytes of WandbData.strings stored after the project table
+  int8_t metric_run_index;    // Run the cached slots belong to (-1 if none)
+  uint8_t metric_page;        // Last viewed metric page of that run
+  uint8_t num_slots;
+  int16_t slot_metric_ids[CACHE_MAX_SLOTS];
+} WarmCacheHeader;
+
+// The project table and the used part of the string table are adjacent in WandbData
+#define CACHE_STRINGS_BLOB_SIZE(strings_used) \
+  (offsetof(WandbData, strings) - offsetof(WandbData, projects) + (strings_used))
+
+#define PERSIST_KEYS_FOR(bytes) (((bytes) + PERSIST_DATA_MAX_LENGTH - 1) / PERSIST_DATA_MAX_LENGTH)
+
+// Only the metric is persisted; graph geometry is rebuilt on first draw
+#define PERSIST_KEYS_PER_SLOT PERSIST_KEYS_FOR(sizeof(WandbMetric))
+
+// Inbound tuples other than the batched metric entries, by role
+typedef enum {
+  INBOX_TRACE_SUMMARY,
+  INBOX_OVERVIEW_DATA,
+  INBOX_OVERVIEW_COUNT,
+  INBOX_OVERVIEW_FIRST,
+  INBOX_RUNS_PATCH,
+  INBOX_RUNS_COUNT,
+  INBOX_RUNS_IS_PAGE,
+  INBOX_RUNS_HAS_MORE,
+  INBOX_RUN_INDEX,
+  INBOX_RUN_NAME,
+  INBOX_RUN_PROJECT,
+  INBOX_RUN_STATE,
+  INBOX_RUN_OWNER,
+  INBOX_METRICS_COUNT,
+  INBOX_FIELD_COUNT,
+} InboxField;
+
+// Fields of one METRIC_*[N] entry
+typedef enum {
+  METRIC_FIELD_INDEX,
+  METRIC_FIELD_NAME,
+  METRIC_FIELD_VALUE,
+  METRIC_FIELD_HISTORY,
+  METRIC_FIELD_HISTORY_DROP,
+  METRIC_FIELD_LAST_STEP,
+  METRIC_FIELD_COUNT,
+} MetricField;
+
+// A received message, filed by role in one pass over the dictionary
+typedef struct {
+  const Tuple *fields[INBOX_FIELD_COUNT];
+  const Tuple *metrics[METRIC_BATCH_MAX][METRIC_FIELD_COUNT];
+  uint8_t metric_entries;   // Bit N set when entry N carries a METRIC_INDEX
+} InboxMessage;
+
+// Maps a run of message keys to where its tuples are filed; keys are only known at runtime
+typedef struct {
+  uint32_t first_key;
+  uint8_t count;
+  uint8_t field;            // InboxField, or MetricField for a METRIC_*[N] array
+  bool metric_array;        // Key offset within the range is the batch entry
+} InboxKeyRange;
+
+#define INBOX_KEY_RANGES (INBOX_FIELD_COUNT + METRIC_FIELD_COUNT)
+_Static_assert(METRIC_BATCH_MAX <= 8, "InboxMessage.metric_entries is an 8-bit mask");
+
 // Static Variables
 static WandbData s_data;
+static RunSectionIndex s_sections;
 static UIState s_ui;
 static MainWindowState s_main;
 static DetailWindowState s_detail;
 static ScrubState s_scrub;
 static ValueAnimState s_value_anim;
 static MetricBuffer s_metric_buffer;
+static OutboundQueue s_outbound;
+static Diagnostics s_diag;
+static DiagnosticsWindowState s_diag_window;
+static OverviewWindowState s_overview;
 static uint8_t s_expected_runs_count;
+static uint8_t s_received_runs_count;
+static bool s_runs_validated;        // Runs list confirmed by the phone this session
+static bool s_runs_paging;           // The batch being received extends the window
+static bool s_runs_has_more;         // The phone has rows past the end of the window
+static bool s_runs_page_pending;     // A runs page is on its way; don't ask again meanwhile
+static int8_t s_buffered_run_index = -1;  // Run whose metrics occupy s_metric_buffer
+static RunIdentity s_buffered_run_snapshot;  // Identity of that run while a fresh list streams in
+static InboxKeyRange s_inbox_keys[INBOX_KEY_RANGES];
+
+// Capacity budgets
+// RAM: the profile-sized statics plus the most the profile lets the heap hold at once
+// (full metric buffer, AppMessage buffers, overview grid). Layers, the graph bitmap and
+// code use the rest of the app's memory.
+#define CAPACITY_STATIC_BYTES \
+  (sizeof(WandbData) + sizeof(RunSectionIndex) + sizeof(OutboundQueue) + \
+   sizeof(Diagnostics) + sizeof(DiagnosticsWindowState))
+#define CAPACITY_HEAP_BYTES \
+  (METRIC_BUFFER_MAX_SLOTS * sizeof(MetricBufferSlot) + APP_MESSAGE_INBOX_CAP + APP_MESSAGE_OUTBOX_SIZE + \
+   MAX_OVERVIEW_TILES * sizeof(OverviewTile))
+_Static_assert(CAPACITY_STATIC_BYTES + CAPACITY_HEAP_BYTES <= CAPACITY_RAM_BUDGET,
+               "Capacity profile exceeds CAPACITY_RAM_BUDGET");
+
+// Storage: a full warm-start cache, and each blob within the keys reserved for it
+_Static_assert(sizeof(WarmCacheHeader) + MAX_WANDB_RUNS * sizeof(WandbRun) +
+               CACHE_STRINGS_BLOB_SIZE(RUN_STRINGS_SIZE) + CACHE_MAX_SLOTS * sizeof(WandbMetric)
+               <= PERSIST_CACHE_BUDGET, "Warm-start cache exceeds PERSIST_CACHE_BUDGET");
+_Static_assert(PERSIST_KEYS_FOR(MAX_WANDB_RUNS * sizeof(WandbRun)) <=
+               PERSIST_KEY_CACHE_STRINGS_BASE - PERSIST_KEY_CACHE_RUNS_BASE, "Runs blob overlaps the strings keys");
+_Static_assert(PERSIST_KEYS_FOR(CACHE_STRINGS_BLOB_SIZE(RUN_STRINGS_SIZE)) <=
+               PERSIST_KEY_CACHE_SLOTS_BASE - PERSIST_KEY_CACHE_STRINGS_BASE, "Strings blob overlaps the slot keys");
+
+// Run indices are int8_t in the UI state and menu lookups
+_Static_assert(MAX_WANDB_RUNS <= INT8_MAX, "MAX_WANDB_RUNS must fit an int8_t run index");
 
 // Text buffers
 #if !defined(PBL_ROUND)
@@ -162,11 +569,91 @@ static inline void mark_graph_dirty(void) {
   if (s_detail.graph_layer) layer_mark_dirty(s_detail.graph_layer);
 }
 
+static inline void mark_indicator_dirty(void) {
+  if (s_detail.indicator_layer) layer_mark_dirty(s_detail.indicator_layer);
+}
+
+// Diagnostics counters
+static uint32_t now_ms(void) {
+  time_t seconds;
+  uint16_t millis;
+  time_ms(&seconds, &millis);
+  return (uint32_t)seconds * 1000 + millis;
+}
+
+static void diag_sample_heap(void) {
+  uint32_t used = heap_bytes_used();
+  if (used > s_diag.heap_high_water) s_diag.heap_high_water = used;
+}
+
+// Start timing a metric request, reusing the longest-waiting entry when all are taken
+static void diag_request_sent(uint8_t first_index, uint8_t count) {
+  uint32_t now = now_ms();
+  uint8_t entry = 0;
+  for (int i = 0; i < DIAG_MAX_PENDING_TIMINGS; i++) {
+    if (!s_diag.pending[i].active) {
+      entry = i;
+      break;
+    }
+    if (now - s_diag.pending[i].sent_ms > now - s_diag.pending[entry].sent_ms) entry = i;
+  }
+  s_diag.pending[entry] = (PendingTiming) {
+    .sent_ms = now,
+    .first_index = first_index,
+    .count = count,
+    .active = true,
+  };
+}
+
+// The first entry back for a timed request ends its measurement
+static void diag_metric_received(uint8_t metric_index) {
+  for (int i = 0; i < DIAG_MAX_PENDING_TIMINGS; i++) {
+    PendingTiming *timing = &s_diag.pending[i];
+    if (!timing->active || metric_index < timing->first_index ||
+        metric_index >= timing->first_index + timing->count) {
+      continue;
+    }
+
+    uint32_t latency = now_ms() - timing->sent_ms;
+    if (s_diag.latency_count == 0 || latency < s_diag.latency_min_ms) s_diag.latency_min_ms = latency;
+    if (latency > s_diag.latency_max_ms) s_diag.latency_max_ms = latency;
+    s_diag.latency_last_ms = latency;
+    s_diag.latency_total_ms += latency;
+    s_diag.latency_count++;
+    timing->active = false;
+    return;
+  }
+}
+
+// Drop a slot's projection (and the pre-rendered graph, which may have been drawn from it)
+static inline void invalidate_graph_geometry(MetricBufferSlot *slot) {
+  slot->geometry.valid = false;
+  s_detail.graph_bitmap_valid = false;
+}
+
 // Buffer management functions
+static void metric_buffer_create(void) {
+  size_t budget = heap_bytes_free() / METRIC_BUFFER_HEAP_DIVISOR;
+  size_t num_slots = budget / sizeof(MetricBufferSlot);
+  if (num_slots < METRIC_BUFFER_MIN_SLOTS) num_slots = METRIC_BUFFER_MIN_SLOTS;
+  if (num_slots > METRIC_BUFFER_MAX_SLOTS) num_slots = METRIC_BUFFER_MAX_SLOTS;
+
+  s_metric_buffer.slots = malloc(num_slots * sizeof(MetricBufferSlot));
+  s_metric_buffer.num_slots = s_metric_buffer.slots ? num_slots : 0;
+}
+
+static void metric_buffer_destroy(void) {
+  free(s_metric_buffer.slots);
+  s_metric_buffer.slots = NULL;
+  s_metric_buffer.num_slots = 0;
+}
+
 static void metric_buffer_init(void) {
-  for (int i = 0; i < METRIC_SLIDING_BUFFER_SLOTS; i++) {
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
     s_metric_buffer.slots[i].metric_id = -1;
     s_metric_buffer.slots[i].state = SLOT_EMPTY;
+    s_metric_buffer.slots[i].stale = false;
+    invalidate_graph_geometry(&s_metric_buffer.slots[i]);
   }
 }
 
@@ -174,17 +661,23 @@ static void metric_buffer_clear(void) {
   metric_buffer_init();
 }
 
-// Get metric from buffer by ID, returns NULL if not ready
-static WandbMetric* get_metric_from_buffer(uint8_t metric_id) {
-  for (int i = 0; i < METRIC_SLIDING_BUFFER_SLOTS; i++) {
+// Get slot from buffer by metric ID, returns NULL if not ready
+static MetricBufferSlot* get_ready_slot(uint8_t metric_id) {
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
     if (s_metric_buffer.slots[i].metric_id == metric_id &&
         s_metric_buffer.slots[i].state == SLOT_READY) {
-      return &s_metric_buffer.slots[i].metric;
+      return &s_metric_buffer.slots[i];
     }
   }
   return NULL;
 }
 
+// Get metric from buffer by ID, returns NULL if not ready
+static WandbMetric* get_metric_from_buffer(uint8_t metric_id) {
+  MetricBufferSlot *slot = get_ready_slot(metric_id);
+  return slot ? &slot->metric : NULL;
+}
+
 // Get current metric from buffer (or NULL if not ready)
 static WandbMetric* get_current_metric(void) {
   return get_metric_from_buffer(s_ui.current_metric_page);
@@ -192,7 +685,7 @@ static WandbMetric* get_current_metric(void) {
 
 // Check if a metric is in the buffer (any state except EMPTY)
 static bool is_metric_in_buffer(uint8_t metric_id) {
-  for (int i = 0; i < METRIC_SLIDING_BUFFER_SLOTS; i++) {
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
     if (s_metric_buffer.slots[i].metric_id == metric_id &&
         s_metric_buffer.slots[i].state != SLOT_EMPTY) {
       return true;
@@ -201,29 +694,72 @@ static bool is_metric_in_buffer(uint8_t metric_id) {
   return false;
 }
 
-// Find best slot for a new metric (LRU-like based on distance from current page)
+// Check if a metric is loading or loaded and up to date (stale slots still need a refresh)
+static bool is_metric_fresh_in_buffer(uint8_t metric_id) {
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
+    if (s_metric_buffer.slots[i].metric_id == metric_id &&
+        s_metric_buffer.slots[i].state != SLOT_EMPTY &&
+        !s_metric_buffer.slots[i].stale) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Mark every loaded slot as due for refresh
+static void metric_buffer_mark_stale(void) {
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
+    if (s_metric_buffer.slots[i].state == SLOT_READY) {
+      s_metric_buffer.slots[i].stale = true;
+    }
+  }
+}
+
+// Metric range worth keeping around the current page: PREFETCH_BEHIND pages against the
+// scroll direction, the rest of the window ahead of it. Clamped to the run's metric count
+// once known; before that the range is speculative and JS trims it.
+static void get_prefetch_window(int *first, int *last) {
+  int window = s_metric_buffer.num_slots < PREFETCH_WINDOW_MAX ? s_metric_buffer.num_slots : PREFETCH_WINDOW_MAX;
+  int behind = PREFETCH_BEHIND;
+  int ahead = window - 1 - behind;
+  int current = s_ui.current_metric_page;
+  int total = s_data.runs[s_ui.selected_run_index].total_metrics;
+
+  *first = s_ui.scroll_delta < 0 ? current - ahead : current - behind;
+  *last = s_ui.scroll_delta < 0 ? current + behind : current + ahead;
+  if (*first < 0) *first = 0;
+  if (total > 0 && *last > total - 1) *last = total - 1;
+}
+
+// Find best slot for a new metric: an empty one, otherwise the one furthest outside the window
 static int8_t find_slot_for_metric(uint8_t metric_id) {
   // First, check if already assigned
-  for (int i = 0; i < METRIC_SLIDING_BUFFER_SLOTS; i++) {
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
     if (s_metric_buffer.slots[i].metric_id == metric_id) {
       return i;
     }
   }
 
   // Find empty slot
-  for (int i = 0; i < METRIC_SLIDING_BUFFER_SLOTS; i++) {
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
     if (s_metric_buffer.slots[i].state == SLOT_EMPTY) {
       return i;
     }
   }
 
-  // Replace the slot furthest from current page
+  // Replace the slot furthest from the prefetch window (ties broken by distance from the page)
+  int first, last;
+  get_prefetch_window(&first, &last);
+
   int max_distance = -1;
   int8_t furthest = 0;
-  for (int i = 0; i < METRIC_SLIDING_BUFFER_SLOTS; i++) {
-    int distance = s_metric_buffer.slots[i].metric_id >= s_ui.current_metric_page
-      ? s_metric_buffer.slots[i].metric_id - s_ui.current_metric_page
-      : s_ui.current_metric_page - s_metric_buffer.slots[i].metric_id;
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
+    int id = s_metric_buffer.slots[i].metric_id;
+    int outside = id < first ? first - id : (id > last ? id - last : 0);
+    int from_page = id >= s_ui.current_metric_page
+      ? id - s_ui.current_metric_page
+      : s_ui.current_metric_page - id;
+    int distance = outside * 256 + from_page;
     if (distance > max_distance) {
       max_distance = distance;
       furthest = i;
@@ -232,163 +768,582 @@ static int8_t find_slot_for_metric(uint8_t metric_id) {
   return furthest;
 }
 
-// Forward declaration for request_metric
-static void request_metric(uint8_t run_index, uint8_t metric_index);
+// Debounce timer for the batched metric window request
+static AppTimer *s_request_timer = NULL;
 
-// Timers for staggered metric requests
-static AppTimer *s_request_current_timer = NULL;
-static AppTimer *s_request_next_timer = NULL;
-static AppTimer *s_request_prev_timer = NULL;
+// Inbox size negotiated in prv_init, reported to JS so it can pack batches to fit
+static uint32_t s_inbox_size;
 
-// Timer for periodic metric refresh
-static AppTimer *s_refresh_timer = NULL;
-static uint32_t s_refresh_interval_ms = METRIC_AUTO_REFRESH_MS;
+// Live update conditions, from the connection and battery services
+static bool s_phone_connected = true;
+static bool s_battery_low = false;
 
-static void cancel_all_request_timers(void) {
-  if (s_request_current_timer) {
-    app_timer_cancel(s_request_current_timer);
-    s_request_current_timer = NULL;
+
+static void cancel_request_timer(void) {
+  if (s_request_timer) {
+    app_timer_cancel(s_request_timer);
+    s_request_timer = NULL;
   }
-  if (s_request_next_timer) {
-    app_timer_cancel(s_request_next_timer);
-    s_request_next_timer = NULL;
+}
+
+// Samples the graph can show at GRAPH_MIN_POINT_SPACING; mirrors the detail window layout
+static uint8_t graph_history_points(void) {
+  int16_t plot_width = PBL_DISPLAY_WIDTH - 2 * (DETAIL_PADDING + DETAIL_GRAPH_INSET + GRAPH_OUTER_MARGIN);
+  int16_t points = plot_width / GRAPH_MIN_POINT_SPACING + 1;
+  return points < MAX_GRAPH_HISTORY_POINTS ? points : MAX_GRAPH_HISTORY_POINTS;
+}
+
+// Outbound request queue
+static void request_queue_pump(void);
+
+// Undo what a dropped request claimed: slots waiting on it go back to EMPTY so they get
+// requested again, and a runs page can be asked for again
+static void release_request(const OutboundRequest *request) {
+  if (request->kind == REQUEST_KIND_RUNS_PAGE) s_runs_page_pending = false;
+  if (request->kind != REQUEST_KIND_METRICS) return;
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
+    MetricBufferSlot *slot = &s_metric_buffer.slots[i];
+    if (slot->state == SLOT_LOADING && slot->metric_id >= request->first_index &&
+        slot->metric_id < request->first_index + request->count) {
+      slot->state = SLOT_EMPTY;
+    }
   }
-  if (s_request_prev_timer) {
-    app_timer_cancel(s_request_prev_timer);
-    s_request_prev_timer = NULL;
+}
+
+static void request_queue_insert_front(OutboundRequest request) {
+  for (int i = s_outbound.count; i > 0; i--) {
+    s_outbound.items[i] = s_outbound.items[i - 1];
   }
+  s_outbound.items[0] = request;
+  s_outbound.count++;
 }
 
-static void do_request_current(void *context) {
-  s_request_current_timer = NULL;
-  request_metric(s_ui.selected_run_index, s_ui.current_metric_page);
+static void request_queue_remove(uint8_t index) {
+  for (int i = index; i < s_outbound.count - 1; i++) {
+    s_outbound.items[i] = s_outbound.items[i + 1];
+  }
+  s_outbound.count--;
 }
 
-static void do_request_next(void *context) {
-  s_request_next_timer = NULL;
-  uint8_t current = s_ui.current_metric_page;
-  uint8_t total = s_data.runs[s_ui.selected_run_index].total_metrics;
-  if (current + 1 < total && !is_metric_in_buffer(current + 1)) {
-    request_metric(s_ui.selected_run_index, current + 1);
+// Make room for `request` in a full queue by dropping the newest least urgent request, unless
+// that's this one; returns false (with `request` released) when it doesn't fit
+static bool request_queue_make_room(const OutboundRequest *request) {
+  if (s_outbound.count < OUTBOUND_QUEUE_CAPACITY) return true;
+
+  uint8_t victim = 0;
+  for (int i = 1; i < s_outbound.count; i++) {
+    if (s_outbound.items[i].priority >= s_outbound.items[victim].priority) victim = i;
+  }
+  if (s_outbound.items[victim].priority <= request->priority) {
+    release_request(request);
+    return false;
   }
+  release_request(&s_outbound.items[victim]);
+  request_queue_remove(victim);
+  return true;
+}
+
+static bool is_same_request(const OutboundRequest *a, const OutboundRequest *b) {
+  return a->kind == b->kind && a->run_index == b->run_index && a->backward == b->backward &&
+         a->first_index == b->first_index && a->count == b->count;
 }
 
-static void do_request_prev(void *context) {
-  s_request_prev_timer = NULL;
-  uint8_t current = s_ui.current_metric_page;
-  if (current > 0 && !is_metric_in_buffer(current - 1)) {
-    request_metric(s_ui.selected_run_index, current - 1);
+static void request_enqueue(OutboundRequest request) {
+  // Already on its way, the response will cover it
+  if (s_outbound.in_flight && is_same_request(&s_outbound.sending, &request)) return;
+
+  // Coalesce with a queued duplicate, keeping the more urgent priority
+  for (int i = 0; i < s_outbound.count; i++) {
+    OutboundRequest *queued = &s_outbound.items[i];
+    // Only the latest subscription or prefetch hint matters
+    if ((request.kind == REQUEST_KIND_SUBSCRIBE || request.kind == REQUEST_KIND_PREFETCH) &&
+        queued->kind == request.kind) {
+      *queued = request;
+      request_queue_pump();
+      return;
+    }
+    if (is_same_request(queued, &request)) {
+      if (request.priority < queued->priority) queued->priority = request.priority;
+      queued->base_step = request.base_step;
+      request_queue_pump();
+      return;
+    }
   }
+
+  if (!request_queue_make_room(&request)) return;
+
+  s_outbound.items[s_outbound.count++] = request;
+  request_queue_pump();
 }
 
-// Request metrics: current immediately, adjacent after delays
-static void request_adjacent_metrics(void) {
-  cancel_all_request_timers();
+// Drop everything queued (e.g. when switching runs); an in-flight message still completes
+static void request_queue_clear(void) {
+  for (int i = 0; i < s_outbound.count; i++) {
+    release_request(&s_outbound.items[i]);
+  }
+  s_outbound.count = 0;
+}
 
-  // Current metric: after short debounce (in case of rapid scrolling)
-  s_request_current_timer = app_timer_register(METRIC_REQUEST_DEBOUNCE_MS, do_request_current, NULL);
+static void request_retry_timer_callback(void *context) {
+  s_outbound.retry_timer = NULL;
+  request_queue_pump();
+}
 
-  // Next metric: after current has time to send
-  s_request_next_timer = app_timer_register(METRIC_REQUEST_DEBOUNCE_MS + ADJACENT_METRIC_STAGGER_MS, do_request_next, NULL);
+// Requeue a failed request at the front with exponential backoff, or give up on it
+static void request_failed(OutboundRequest request, AppMessageResult reason) {
+  s_diag.outbox_failures++;
+  request.attempts++;
+  if (request.attempts >= OUTBOUND_MAX_ATTEMPTS) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Dropping request (kind %d) for %d/%d+%d: %d",
+            request.kind, request.run_index, request.first_index, request.count, reason);
+    release_request(&request);
+    request_queue_pump();
+    return;
+  }
 
-  // Previous metric: after next has time to send
-  s_request_prev_timer = app_timer_register(METRIC_REQUEST_DEBOUNCE_MS + ADJACENT_METRIC_STAGGER_MS * 2, do_request_prev, NULL);
+  // The queue may have filled up while this was in flight
+  if (!request_queue_make_room(&request)) {
+    request_queue_pump();
+    return;
+  }
+  request_queue_insert_front(request);
+  if (!s_outbound.retry_timer) {
+    uint32_t delay = OUTBOUND_RETRY_BASE_MS << (request.attempts - 1);
+    s_outbound.retry_timer = app_timer_register(delay, request_retry_timer_callback, NULL);
+  }
 }
 
-// Refresh current metric without changing slot state (no skeleton shown)
-static void refresh_current_metric(void) {
-  // Only refresh if current metric is already loaded
-  WandbMetric *metric = get_current_metric();
-  if (!metric) return;
+// Snapshot of the counters in DIAGNOSTICS export order (little-endian uint32s on the wire):
+// answered requests, mean/min/max/last latency (ms), buffer hits, misses, inbox drops,
+// outbox failures, bytes received, heap high-water mark, heap in use now, time to first
+// runs row, last time from run selection to metric (ms), skeleton frames, bytes sent
+static void diag_export_fields(uint32_t *fields) {
+  uint32_t count = s_diag.latency_count;
+  fields[0] = count;
+  fields[1] = count ? s_diag.latency_total_ms / count : 0;
+  fields[2] = s_diag.latency_min_ms;
+  fields[3] = s_diag.latency_max_ms;
+  fields[4] = s_diag.latency_last_ms;
+  fields[5] = s_diag.buffer_hits;
+  fields[6] = s_diag.buffer_misses;
+  fields[7] = s_diag.inbox_drops;
+  fields[8] = s_diag.outbox_failures;
+  fields[9] = s_diag.bytes_received;
+  fields[10] = s_diag.heap_high_water;
+  fields[11] = heap_bytes_used();
+  fields[12] = s_diag.first_row_ms;
+  fields[13] = s_diag.open_to_metric_ms;
+  fields[14] = s_diag.skeleton_frames;
+  fields[15] = s_diag.bytes_sent;
+}
+
+// Send the most urgent queued request if the outbox is idle
+static void request_queue_pump(void) {
+  if (s_outbound.in_flight || s_outbound.retry_timer || s_outbound.count == 0) return;
+
+  // Most urgent first, oldest first among equals
+  uint8_t best = 0;
+  for (int i = 1; i < s_outbound.count; i++) {
+    if (s_outbound.items[i].priority < s_outbound.items[best].priority) best = i;
+  }
+  OutboundRequest request = s_outbound.items[best];
+  request_queue_remove(best);
 
   DictionaryIterator *iter;
   AppMessageResult result = app_message_outbox_begin(&iter);
-  if (result != APP_MSG_OK) return;
+  if (result != APP_MSG_OK) {
+    request_failed(request, result);
+    return;
+  }
+
+  switch (request.kind) {
+    case REQUEST_KIND_METRICS:
+      dict_write_uint16(iter, MESSAGE_KEY_FETCH_RUN_INDEX, request.run_index);
+      dict_write_uint8(iter, MESSAGE_KEY_FETCH_METRIC_INDEX, request.first_index);
+      dict_write_uint8(iter, MESSAGE_KEY_FETCH_METRIC_COUNT, request.count);
+      break;
+    case REQUEST_KIND_SUBSCRIBE:
+      dict_write_uint16(iter, MESSAGE_KEY_SUBSCRIBE_RUN_INDEX, request.run_index);
+      dict_write_uint8(iter, MESSAGE_KEY_SUBSCRIBE_METRIC_INDEX, request.first_index);
+      dict_write_uint8(iter, MESSAGE_KEY_SUBSCRIBE_METRIC_COUNT, request.count);
+      break;
+    case REQUEST_KIND_RUNS_PAGE:
+      dict_write_uint16(iter, MESSAGE_KEY_FETCH_RUNS_START, request.run_index);
+      dict_write_uint8(iter, MESSAGE_KEY_FETCH_RUNS_BACKWARD, request.backward);
+      break;
+    case REQUEST_KIND_DIAGNOSTICS: {
+      // Counters as of sending, packed so they fit the small outbox alongside nothing else
+      uint32_t fields[DIAG_EXPORT_FIELDS];
+      diag_export_fields(fields);
+      dict_write_data(iter, MESSAGE_KEY_DIAGNOSTICS, (const uint8_t *)fields, sizeof(fields));
+      break;
+    }
+    case REQUEST_KIND_TRACE:
+      dict_write_uint8(iter, MESSAGE_KEY_FETCH_TRACE, 1);
+      break;
+    case REQUEST_KIND_OVERVIEW:
+      dict_write_uint16(iter, MESSAGE_KEY_FETCH_OVERVIEW_RUN, request.run_index);
+      dict_write_uint8(iter, MESSAGE_KEY_FETCH_METRIC_COUNT, request.count);
+      break;
+    case REQUEST_KIND_PREFETCH:
+      dict_write_uint16(iter, MESSAGE_KEY_PREFETCH_RUN_INDEX, request.run_index);
+      break;
+  }
+  if (request.kind != REQUEST_KIND_DIAGNOSTICS && request.kind != REQUEST_KIND_TRACE) {
+    dict_write_uint16(iter, MESSAGE_KEY_FETCH_INBOX_SIZE, s_inbox_size);
+    dict_write_uint8(iter, MESSAGE_KEY_FETCH_HISTORY_POINTS, graph_history_points());
+  }
+  if (request.base_step >= 0) {
+    dict_write_int32(iter, MESSAGE_KEY_FETCH_BASE_STEP, request.base_step);
+  }
+
+  uint32_t size = dict_size(iter);
+  result = app_message_outbox_send();
+  if (result != APP_MSG_OK) {
+    request_failed(request, result);
+    return;
+  }
+  s_diag.bytes_sent += size;
+  if (request.kind == REQUEST_KIND_METRICS) diag_request_sent(request.first_index, request.count);
+
+  s_outbound.in_flight = true;
+  s_outbound.sending = request;
+}
+
+static void outbox_sent_callback(DictionaryIterator *iter, void *context) {
+  s_outbound.in_flight = false;
+  request_queue_pump();
+}
 
-  dict_write_uint8(iter, MESSAGE_KEY_FETCH_RUN_INDEX, s_ui.selected_run_index);
-  dict_write_uint8(iter, MESSAGE_KEY_FETCH_METRIC_INDEX, s_ui.current_metric_page);
-  app_message_outbox_send();
+static void outbox_failed_callback(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+  s_outbound.in_flight = false;
+  request_failed(s_outbound.sending, reason);
 }
 
-static void refresh_timer_callback(void *context) {
-  s_refresh_timer = NULL;
+// Queue a contiguous range of metrics (JS clamps it to the run's metric count)
+static void request_metrics(uint16_t run_index, uint8_t first_index, uint8_t count, RequestPriority priority) {
+  // Cached run indices may not match the phone's list yet; the window is re-requested once it does
+  if (!s_runs_validated) return;
 
-  // Only refresh if detail window is open
-  if (!s_detail.window) return;
+  if (count > s_metric_buffer.num_slots) count = s_metric_buffer.num_slots;
+
+  // Mark missing slots as loading (ready ones keep showing while refreshed)
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t metric_index = first_index + i;
+    if (is_metric_in_buffer(metric_index)) continue;
+
+    int8_t slot = find_slot_for_metric(metric_index);
+    s_metric_buffer.slots[slot].metric_id = metric_index;
+    s_metric_buffer.slots[slot].state = SLOT_LOADING;
+  }
+
+  // A stale copy of the first metric lets the phone reply with only the new samples
+  WandbMetric *held = get_metric_from_buffer(first_index);
+  request_enqueue((OutboundRequest) {
+    .priority = priority,
+    .kind = REQUEST_KIND_METRICS,
+    .run_index = run_index,
+    .first_index = first_index,
+    .count = count,
+    .base_step = held ? held->last_step : -1,
+  });
+}
+
+// Ask the phone to push changes to a range of metrics as it polls W&B (count 0 stops pushes)
+static void subscribe_metrics(uint16_t run_index, uint8_t first_index, uint8_t count) {
+  request_enqueue((OutboundRequest) {
+    .priority = REQUEST_PRIORITY_SUBSCRIPTION,
+    .kind = REQUEST_KIND_SUBSCRIBE,
+    .run_index = run_index,
+    .first_index = first_index,
+    .count = count,
+    .base_step = -1,
+  });
+}
+
+// Ask for the runs page after (or, backward, before) list index `start`
+static void request_runs_page(uint16_t start, bool backward) {
+  if (s_runs_page_pending || !s_runs_validated) return;
+  s_runs_page_pending = true;
+  request_enqueue((OutboundRequest) {
+    .priority = REQUEST_PRIORITY_NEIGHBOURS,
+    .kind = REQUEST_KIND_RUNS_PAGE,
+    .run_index = start,
+    .backward = backward,
+    .base_step = -1,
+  });
+}
+
+// Send the diagnostics counters to the phone, which writes them to its log
+static void request_diagnostics_export(void) {
+  request_enqueue((OutboundRequest) {
+    .priority = REQUEST_PRIORITY_SUBSCRIPTION,
+    .kind = REQUEST_KIND_DIAGNOSTICS,
+    .base_step = -1,
+  });
+}
+
+static void request_trace_summary(void) {
+  request_enqueue((OutboundRequest) {
+    .priority = REQUEST_PRIORITY_SUBSCRIPTION,
+    .kind = REQUEST_KIND_TRACE,
+    .base_step = -1,
+  });
+}
+
+// Ask for the overview tiles of a run's first metrics
+static void request_overview(uint16_t run_index) {
+  request_enqueue((OutboundRequest) {
+    .priority = REQUEST_PRIORITY_CURRENT,
+    .kind = REQUEST_KIND_OVERVIEW,
+    .run_index = run_index,
+    .count = MAX_OVERVIEW_TILES,
+    .base_step = -1,
+  });
+}
+
+// Hint the phone to fetch a run's metric names and first metrics before it is opened
+static void request_run_prefetch(uint16_t run_index) {
+  request_enqueue((OutboundRequest) {
+    .priority = REQUEST_PRIORITY_HINT,
+    .kind = REQUEST_KIND_PREFETCH,
+    .run_index = run_index,
+    .base_step = -1,
+  });
+}
+
+// Request the prefetch window around the current page in one batch, skipping buffered edges
+static void do_request_window(void *context) {
+  s_request_timer = NULL;
+  int current = s_ui.current_metric_page;
+  uint16_t list_index = s_data.runs[s_ui.selected_run_index].list_index;
+  int first, last;
+  get_prefetch_window(&first, &last);
+
+  // Live updates follow the whole window, so neighbours are current when scrolled to
+  if (s_runs_validated) {
+    uint8_t count = s_battery_low ? 0 : last - first + 1;
+    subscribe_metrics(list_index, first, count);
+  }
+
+  while (first <= last && is_metric_fresh_in_buffer(first)) first++;
+  while (last >= first && is_metric_fresh_in_buffer(last)) last--;
+  if (first > last) return;
+
+  // Neighbour-only prefetches yield to anything involving the page on screen
+  RequestPriority priority = (first <= current && current <= last)
+    ? REQUEST_PRIORITY_CURRENT : REQUEST_PRIORITY_NEIGHBOURS;
+  request_metrics(list_index, first, last - first + 1, priority);
+}
+
+// Request metrics around the current page after a short debounce (in case of rapid scrolling)
+static void request_adjacent_metrics(void) {
+  cancel_request_timer();
+  s_request_timer = app_timer_register(METRIC_REQUEST_DEBOUNCE_MS, do_request_window, NULL);
+}
 
-  refresh_current_metric();
+// Nothing reaches the phone while disconnected, and it stops pushing once a push fails;
+// on reconnect, revalidate what's shown and subscribe again
+static void app_connection_handler(bool connected) {
+  bool reconnected = connected && !s_phone_connected;
+  s_phone_connected = connected;
+  if (!reconnected || !s_detail.window) return;
 
-  // Schedule next refresh
-  s_refresh_timer = app_timer_register(s_refresh_interval_ms, refresh_timer_callback, NULL);
+  metric_buffer_mark_stale();
+  request_adjacent_metrics();
 }
 
-static void restart_refresh_timer(void) {
-  if (s_refresh_timer) {
-    app_timer_cancel(s_refresh_timer);
+static void battery_state_handler(BatteryChargeState charge) {
+  bool low = !charge.is_charging && !charge.is_plugged &&
+             charge.charge_percent <= LIVE_UPDATES_MIN_BATTERY_PERCENT;
+  if (low == s_battery_low) return;
+  s_battery_low = low;
+
+  // Cancel or restore the subscription; the window's own fetches still happen on scroll
+  if (s_detail.window) {
+    request_adjacent_metrics();
   }
-  s_refresh_timer = app_timer_register(s_refresh_interval_ms, refresh_timer_callback, NULL);
 }
 
 static int32_t lerp_fixed(int32_t from, int32_t to, AnimationProgress progress) {
   return from + (int32_t)(((int64_t)progress * (to - from)) / ANIMATION_NORMALIZED_MAX);
 }
 
-// Menu section helpers - sections correspond to unique states
-// Returns the state string for a given section index (based on first occurrence order)
-static const char* get_state_for_section(uint16_t section) {
-  uint8_t unique_count = 0;
+static int64_t lerp_fixed64(int64_t from, int64_t to, AnimationProgress progress) {
+  return from + ((to - from) * progress) / ANIMATION_NORMALIZED_MAX;
+}
+
+// Run string table: names live back to back in s_data.strings, projects are shared entries
+static inline const char *run_name(const WandbRun *run) {
+  return &s_data.strings[run->name_offset];
+}
+
+static inline const char *run_project_name(const WandbRun *run) {
+  if (run->project == RUN_PROJECT_NONE) return "";
+  return &s_data.strings[s_data.projects[run->project].offset];
+}
+
+// Append `str`, truncated to MAX_RUN_NAME_CHARS like the fields it replaces; false if full
+static bool strings_add(const char *str, uint16_t *offset) {
+  size_t len = strlen(str);
+  if (len > MAX_RUN_NAME_CHARS - 1) len = MAX_RUN_NAME_CHARS - 1;
+  if (s_data.strings_used + len + 1 > RUN_STRINGS_SIZE) return false;
+
+  *offset = s_data.strings_used;
+  memcpy(&s_data.strings[*offset], str, len);
+  s_data.strings[*offset + len] = '\0';
+  s_data.strings_used += len + 1;
+  return true;
+}
+
+// Close the gap left by the string at `offset`, moving every later string (and its users) down
+static void strings_remove(uint16_t offset) {
+  uint16_t size = strlen(&s_data.strings[offset]) + 1;
+  memmove(&s_data.strings[offset], &s_data.strings[offset + size], s_data.strings_used - offset - size);
+  s_data.strings_used -= size;
+
   for (int i = 0; i < s_data.num_runs; i++) {
-    // Check if this is the first occurrence of this state
-    bool is_first = true;
-    for (int j = 0; j < i; j++) {
-      if (strcmp(s_data.runs[j].state, s_data.runs[i].state) == 0) {
-        is_first = false;
-        break;
-      }
-    }
-    if (is_first) {
-      if (unique_count == section) return s_data.runs[i].state;
-      unique_count++;
+    if (s_data.runs[i].name_offset > offset) s_data.runs[i].name_offset -= size;
+  }
+  for (int i = 0; i < MAX_RUN_PROJECTS; i++) {
+    RunProject *project = &s_data.projects[i];
+    if (project->refs > 0 && project->offset > offset) project->offset -= size;
+  }
+}
+
+// Find the project entry for the phone's `phone_id`, adding it if `name` came along.
+// The phone sends the name with the first row of each batch that uses the project.
+static uint8_t project_intern(uint8_t phone_id, const char *name) {
+  uint8_t found = RUN_PROJECT_NONE;
+  uint8_t free_entry = RUN_PROJECT_NONE;
+
+  for (uint8_t i = 0; i < MAX_RUN_PROJECTS; i++) {
+    RunProject *project = &s_data.projects[i];
+    if (project->refs == 0) {
+      if (free_entry == RUN_PROJECT_NONE) free_entry = i;
+    } else if (name ? strncmp(&s_data.strings[project->offset], name, MAX_RUN_NAME_CHARS - 1) == 0
+                    : project->phone_id == phone_id) {
+      found = i;
+    } else if (name && project->phone_id == phone_id) {
+      // The phone reused the ID for another project; runs already pointing here keep their name
+      project->phone_id = RUN_PROJECT_NONE;
     }
   }
-  return NULL;
+
+  if (found == RUN_PROJECT_NONE && name && free_entry != RUN_PROJECT_NONE &&
+      strings_add(name, &s_data.projects[free_entry].offset)) {
+    found = free_entry;
+  }
+  if (found != RUN_PROJECT_NONE) s_data.projects[found].phone_id = phone_id;
+  return found;
+}
+
+static void project_release(uint8_t index) {
+  if (index == RUN_PROJECT_NONE) return;
+  RunProject *project = &s_data.projects[index];
+  if (--project->refs == 0) strings_remove(project->offset);
+}
+
+// Intern a received row's strings into `run`; false (with nothing held) if the tables are full
+static bool run_intern_strings(WandbRun *run, const char *name, uint8_t phone_id, const char *project_name) {
+  run->project = project_intern(phone_id, project_name);
+  if (run->project == RUN_PROJECT_NONE && project_name) return false;
+  if (run->project != RUN_PROJECT_NONE) s_data.projects[run->project].refs++;
+
+  if (strings_add(name, &run->name_offset)) return true;
+  project_release(run->project);
+  return false;
+}
+
+static void run_release_strings(const WandbRun *run) {
+  strings_remove(run->name_offset);
+  project_release(run->project);
 }
 
-static uint8_t count_unique_states(void) {
-  uint8_t count = 0;
+// Copy the buffered run's identity out of the string table, which a fresh list rewrites
+static void snapshot_buffered_run(void) {
+  const WandbRun *run = &s_data.runs[s_buffered_run_index];
+  strncpy(s_buffered_run_snapshot.run_name, run_name(run), MAX_RUN_NAME_CHARS - 1);
+  strncpy(s_buffered_run_snapshot.project_name, run_project_name(run), MAX_RUN_NAME_CHARS - 1);
+  s_buffered_run_snapshot.total_metrics = run->total_metrics;
+}
+
+// Menu section helpers - sections correspond to unique states
+static const char *const s_run_state_names[RUN_STATE_COUNT] = {
+  [RUN_STATE_RUNNING] = "running",
+  [RUN_STATE_PENDING] = "pending",
+  [RUN_STATE_FINISHED] = "finished",
+  [RUN_STATE_CRASHED] = "crashed",
+  [RUN_STATE_FAILED] = "failed",
+  [RUN_STATE_KILLED] = "killed",
+  [RUN_STATE_PREEMPTED] = "preempted",
+  [RUN_STATE_OTHER] = "other",
+  [RUN_STATE_REMOVED] = "removed",
+};
+
+static RunState parse_run_state(const char *name) {
+  for (int i = 0; i < RUN_STATE_COUNT; i++) {
+    if (i != RUN_STATE_OTHER && strcmp(name, s_run_state_names[i]) == 0) return i;
+  }
+  return RUN_STATE_OTHER;
+}
+
+// Group runs into sections by state, keeping the list's order within and across sections.
+// Removed runs get no section.
+static void rebuild_run_sections(void) {
+  int8_t section_for_state[RUN_STATE_COUNT];
+  memset(section_for_state, -1, sizeof(section_for_state));
+  s_sections.num_sections = 0;
+
   for (int i = 0; i < s_data.num_runs; i++) {
-    bool is_first = true;
-    for (int j = 0; j < i; j++) {
-      if (strcmp(s_data.runs[j].state, s_data.runs[i].state) == 0) {
-        is_first = false;
-        break;
-      }
+    uint8_t state = s_data.runs[i].state;
+    if (state == RUN_STATE_REMOVED) continue;
+    if (section_for_state[state] < 0) {
+      section_for_state[state] = s_sections.num_sections;
+      s_sections.sections[s_sections.num_sections++] = (RunSection) { .state = state };
     }
-    if (is_first) count++;
+    s_sections.sections[section_for_state[state]].num_rows++;
+  }
+
+  uint8_t offset = 0;
+  for (int i = 0; i < s_sections.num_sections; i++) {
+    s_sections.sections[i].first_row = offset;
+    offset += s_sections.sections[i].num_rows;
+    s_sections.sections[i].num_rows = 0;
   }
-  return count;
-}
 
-static uint8_t count_runs_with_state(const char *state) {
-  uint8_t count = 0;
   for (int i = 0; i < s_data.num_runs; i++) {
-    if (strcmp(s_data.runs[i].state, state) == 0) count++;
+    if (s_data.runs[i].state == RUN_STATE_REMOVED) continue;
+    RunSection *section = &s_sections.sections[section_for_state[s_data.runs[i].state]];
+    s_sections.run_indices[section->first_row + section->num_rows++] = i;
   }
-  return count;
+}
+
+static const RunSection *get_section(uint16_t section) {
+  return section < s_sections.num_sections ? &s_sections.sections[section] : NULL;
 }
 
 static int8_t get_run_index_for_section_row(uint16_t section, uint16_t row) {
-  const char *state = get_state_for_section(section);
-  if (!state) return -1;
+  const RunSection *run_section = get_section(section);
+  if (!run_section || row >= run_section->num_rows) return -1;
+  return s_sections.run_indices[run_section->first_row + row];
+}
 
-  uint8_t found = 0;
-  for (int i = 0; i < s_data.num_runs; i++) {
-    if (strcmp(s_data.runs[i].state, state) == 0) {
-      if (found == row) return i;
-      found++;
+// Rows the menu shows: every run but the removed ones
+static uint8_t get_num_visible_runs(void) {
+  if (s_sections.num_sections == 0) return 0;
+  const RunSection *last = &s_sections.sections[s_sections.num_sections - 1];
+  return last->first_row + last->num_rows;
+}
+
+static MenuIndex get_menu_index_for_run(uint8_t run_index) {
+  for (int i = 0; i < s_sections.num_sections; i++) {
+    const RunSection *section = &s_sections.sections[i];
+    for (int row = 0; row < section->num_rows; row++) {
+      if (s_sections.run_indices[section->first_row + row] == run_index) return MenuIndex(i, row);
     }
   }
-  return -1;
+  return MenuIndex(0, 0);
 }
 
 // Detail Window - Display Updates
@@ -429,11 +1384,6 @@ static void update_detail_text(void) {
 }
 
 // Detail Window - Graph Drawing
-typedef struct {
-  int64_t min;
-  int64_t max;
-  int64_t range;
-} ValueRange;
 
 static ValueRange calculate_value_range(const int64_t *values, uint8_t count) {
   ValueRange r = { .min = values[0], .max = values[0] };
@@ -457,6 +1407,21 @@ static void calculate_graph_points(GPoint *points, const int64_t *history,
   }
 }
 
+// Project the slot's history for the given bounds, reusing the last projection when still valid
+static const GraphGeometry *get_graph_geometry(MetricBufferSlot *slot, GRect bounds) {
+  GraphGeometry *geometry = &slot->geometry;
+  if (geometry->valid && geometry->size.w == bounds.size.w && geometry->size.h == bounds.size.h) {
+    return geometry;
+  }
+
+  WandbMetric *metric = &slot->metric;
+  geometry->range = calculate_value_range(metric->history, metric->history_count);
+  calculate_graph_points(geometry->points, metric->history, metric->history_count, bounds, geometry->range);
+  geometry->size = bounds.size;
+  geometry->valid = true;
+  return geometry;
+}
+
 static void draw_data_points(GContext *ctx, const GPoint *points, uint8_t count) {
   #if defined(PBL_COLOR)
     graphics_context_set_fill_color(ctx, GColorLightGray);
@@ -551,15 +1516,72 @@ static void draw_skeleton_rects(GContext *ctx, GRect graph_bounds) {
   graphics_fill_rect(ctx, graph_bounds, 0, GCornerNone);
 }
 
-static void graph_layer_update_proc(Layer *layer, GContext *ctx) {
-  GRect bounds = layer_get_bounds(layer);
-  WandbMetric *metric = get_metric_from_buffer(s_ui.graph_display_page);
+// Copy a screen-space rect of the frame buffer into the graph bitmap (formats match per platform)
+static void copy_frame_buffer_rect(GBitmap *frame_buffer, GRect rect, GBitmap *dest) {
+  uint8_t *dest_data = gbitmap_get_data(dest);
+  uint16_t dest_stride = gbitmap_get_bytes_per_row(dest);
+
+  for (int16_t y = 0; y < rect.size.h; y++) {
+    GBitmapDataRowInfo row = gbitmap_get_data_row_info(frame_buffer, rect.origin.y + y);
+    uint8_t *dest_row = dest_data + y * dest_stride;
+    for (int16_t x = 0; x < rect.size.w; x++) {
+      int16_t src_x = rect.origin.x + x;
+      // Pixels outside a round display's visible row span read as background
+      bool visible = src_x >= row.min_x && src_x <= row.max_x;
+      #if defined(PBL_COLOR)
+        dest_row[x] = visible ? row.data[src_x] : GColorWhite.argb;
+      #else
+        uint8_t bit = 1 << (x % 8);
+        if (!visible || (row.data[src_x / 8] & (1 << (src_x % 8)))) {
+          dest_row[x / 8] |= bit;
+        } else {
+          dest_row[x / 8] &= ~bit;
+        }
+      #endif
+    }
+  }
+}
+
+// Snapshot what was just drawn for the graph layer so later frames can blit it
+static void capture_graph_bitmap(Layer *layer, GContext *ctx, int16_t metric_id) {
+  if (!s_detail.graph_bitmap) return;
+
+  // Only capture at rest; mid-slide the layer may be partly offscreen
+  GRect frame = layer_get_frame(layer);
+  if (!grect_equal(&frame, &s_detail.graph_frame)) return;
+
+  GBitmap *frame_buffer = graphics_capture_frame_buffer(ctx);
+  if (!frame_buffer) return;
+
+  GRect screen = gbitmap_get_bounds(frame_buffer);
+  if (frame.origin.x >= 0 && frame.origin.y >= 0 &&
+      frame.origin.x + frame.size.w <= screen.size.w &&
+      frame.origin.y + frame.size.h <= screen.size.h) {
+    copy_frame_buffer_rect(frame_buffer, frame, s_detail.graph_bitmap);
+    s_detail.graph_bitmap_metric = metric_id;
+    s_detail.graph_bitmap_scrub = s_scrub.active;
+    s_detail.graph_bitmap_valid = true;
+  }
+  graphics_release_frame_buffer(ctx, frame_buffer);
+}
+
+static bool graph_bitmap_matches(int16_t metric_id) {
+  return s_detail.graph_bitmap_valid &&
+         s_detail.graph_bitmap_metric == metric_id &&
+         s_detail.graph_bitmap_scrub == s_scrub.active;
+}
+
+static void graph_layer_update_proc(Layer *layer, GContext *ctx) {
+  GRect bounds = layer_get_bounds(layer);
+  MetricBufferSlot *slot = get_ready_slot(s_ui.graph_display_page);
 
   // Draw skeleton if metric not loaded
-  if (!metric) {
+  if (!slot) {
+    s_diag.skeleton_frames++;
     draw_skeleton_rects(ctx, bounds);
     return;
   }
+  WandbMetric *metric = &slot->metric;
 
   // Draw graph skeleton if insufficient history (but name/value are valid)
   if (metric->history_count < 2) {
@@ -568,10 +1590,12 @@ static void graph_layer_update_proc(Layer *layer, GContext *ctx) {
     return;
   }
 
-  ValueRange range = calculate_value_range(metric->history, metric->history_count);
+  if (graph_bitmap_matches(slot->metric_id)) {
+    graphics_draw_bitmap_in_rect(ctx, s_detail.graph_bitmap, bounds);
+    return;
+  }
 
-  GPoint points[MAX_GRAPH_HISTORY_POINTS];
-  calculate_graph_points(points, metric->history, metric->history_count, bounds, range);
+  const GPoint *points = get_graph_geometry(slot, bounds)->points;
 
   if (s_scrub.active) {
     draw_data_points(ctx, points, metric->history_count);
@@ -579,75 +1603,63 @@ static void graph_layer_update_proc(Layer *layer, GContext *ctx) {
     draw_line_graph(ctx, points, metric->history_count);
   }
 
+  capture_graph_bitmap(layer, ctx, slot->metric_id);
+}
+
+static void indicator_layer_update_proc(Layer *layer, GContext *ctx) {
+  MetricBufferSlot *slot = get_ready_slot(s_ui.graph_display_page);
+  if (!slot || slot->metric.history_count < 2) return;
+
+  uint8_t count = slot->metric.history_count;
+  const GPoint *points = get_graph_geometry(slot, layer_get_bounds(layer))->points;
+
   GPoint indicator = s_scrub.active
-    ? interpolate_indicator_position(points, metric->history_count, s_scrub.current_index_fixed)
-    : points[metric->history_count - 1];
+    ? interpolate_indicator_position(points, count, s_scrub.current_index_fixed)
+    : points[count - 1];
 
   draw_indicator(ctx, indicator);
 }
 
 // Detail Window - Animations
-// Parse string to fixed-point integer (scaled by FIXED_POINT_SCALE)
-static int32_t parse_fixed_point(const char *str, int *decimals) {
-  int32_t result = 0;
-  int sign = 1;
-  int decimal_places = 0;
-  bool seen_decimal = false;
-
-  if (*str == '-') {
-    sign = -1;
-    str++;
-  }
-
-  while (*str) {
-    if (*str == '.') {
-      seen_decimal = true;
-    } else if (*str >= '0' && *str <= '9') {
-      result = result * 10 + (*str - '0');
-      if (seen_decimal) {
-        decimal_places++;
-        if (decimal_places >= 4) break;  // Max 4 decimal places
-      }
-    } else {
-      break;  // Stop on non-numeric character
-    }
-    str++;
+// Fixed-point units per last shown digit, by decimal places
+static const int32_t s_decimal_units[MAX_VALUE_DECIMALS + 1] = { 10000, 1000, 100, 10, 1 };
+
+// Value in units of its last shown digit, truncated toward zero like format_fixed_point
+static inline int64_t fixed_point_at_decimals(int64_t value, uint8_t decimals) {
+  return value / s_decimal_units[decimals];
+}
+
+// Format fixed-point value back to string, truncated to `decimals` places.
+// Runs every animation frame, so digits are written directly rather than through snprintf.
+static void format_fixed_point(int64_t value, uint8_t decimals, char *buffer, size_t size) {
+  int64_t shown = fixed_point_at_decimals(value, decimals);
+  bool negative = shown < 0;
+  uint64_t magnitude = negative ? -(uint64_t)shown : (uint64_t)shown;
+
+  // Built backwards from the last digit
+  char reversed[24];
+  int length = 0;
+  for (uint8_t i = 0; i < decimals; i++) {
+    reversed[length++] = '0' + magnitude % 10;
+    magnitude /= 10;
   }
-
-  // Scale to fixed point (4 decimal places)
-  for (int i = decimal_places; i < 4; i++) {
-    result *= 10;
-  }
-
-  *decimals = decimal_places;
-  return sign * result;
-}
-
-// Format fixed-point value back to string
-static void format_fixed_point(int64_t value, int decimals, char *buffer, size_t size) {
-  bool negative = value < 0;
-  if (negative) value = -value;
-
-  int64_t integer_part = value / VALUE_INTERPOLATION_SCALE;
-  int64_t frac_part = value % VALUE_INTERPOLATION_SCALE;
-
-  if (decimals == 0) {
-    snprintf(buffer, size, "%s%ld", negative ? "-" : "", (long)integer_part);
-  } else {
-    // Adjust fractional part based on desired decimals
-    int divisor = 1;
-    for (int i = 0; i < 4 - decimals; i++) divisor *= 10;
-    frac_part /= divisor;
-
-    char fmt[16];
-    snprintf(fmt, sizeof(fmt), "%%s%%ld.%%0%dld", decimals);
-    snprintf(buffer, size, fmt, negative ? "-" : "", (long)integer_part, (long)frac_part);
+  if (decimals > 0) reversed[length++] = '.';
+  do {
+    reversed[length++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while (magnitude > 0);
+  if (negative) reversed[length++] = '-';
+
+  size_t out = 0;
+  while (length > 0 && out < size - 1) {
+    buffer[out++] = reversed[--length];
   }
+  buffer[out] = '\0';
 }
 
 // Custom update function for value interpolation
 static void value_animation_update(Animation *animation, const AnimationProgress progress) {
-  int32_t current = lerp_fixed(s_value_anim.from, s_value_anim.to, progress);
+  int64_t current = lerp_fixed64(s_value_anim.from, s_value_anim.to, progress);
   format_fixed_point(current, s_value_anim.decimals, s_value_anim.buffer, sizeof(s_value_anim.buffer));
   text_layer_set_text(s_detail.value_layer, s_value_anim.buffer);
 }
@@ -665,11 +1677,11 @@ static const AnimationImplementation s_value_animation_impl = {
   .teardown = value_animation_teardown,
 };
 
-static Animation *create_value_interpolation_animation(const char *from_value, const char *to_value) {
-  int from_decimals, to_decimals;
-  s_value_anim.from = parse_fixed_point(from_value, &from_decimals);
-  s_value_anim.to = parse_fixed_point(to_value, &to_decimals);
-  s_value_anim.decimals = (from_decimals > to_decimals) ? from_decimals : to_decimals;
+static Animation *create_value_interpolation_animation(int64_t from_value, uint8_t from_decimals,
+                                                       const WandbMetric *to) {
+  s_value_anim.from = from_value;
+  s_value_anim.to = to->value_fixed;
+  s_value_anim.decimals = (from_decimals > to->value_decimals) ? from_decimals : to->value_decimals;
 
   Animation *anim = animation_create();
   animation_set_implementation(anim, &s_value_animation_impl);
@@ -742,7 +1754,8 @@ static Animation *create_layer_bounce_animation(Layer *layer, GRect *home_frame,
   return animation_sequence_create((Animation *)anim_out, (Animation *)anim_back, NULL);
 }
 
-static Animation *create_scroll_animation(ScrollDirection direction, const char *old_value) {
+// `old_metric` is the metric scrolled away from (NULL if it was a skeleton)
+static Animation *create_scroll_animation(ScrollDirection direction, const WandbMetric *old_metric) {
   WandbMetric *metric = get_current_metric();
 
   Animation *name_anim = create_layer_slide_animation(
@@ -750,14 +1763,15 @@ static Animation *create_scroll_animation(ScrollDirection direction, const char
   Animation *graph_anim = create_layer_slide_animation(
     s_detail.graph_layer, &s_detail.graph_frame, direction, NULL);
 
-  // Only animate value interpolation when both old and new metrics are loaded
-  if (metric && old_value) {
-    Animation *value_anim = create_value_interpolation_animation(old_value, metric->value);
+  // Only animate value interpolation when both old and new metrics have values
+  if (metric && old_metric && metric->has_value && old_metric->has_value) {
+    Animation *value_anim = create_value_interpolation_animation(
+      old_metric->value_fixed, old_metric->value_decimals, metric);
     return animation_spawn_create(value_anim, name_anim, graph_anim, NULL);
   }
 
   // Skeleton to skeleton - hide stale value from previously loaded metric
-  if (!metric && !old_value) {
+  if (!metric && !old_metric) {
     layer_set_hidden(text_layer_get_layer(s_detail.value_layer), true);
   }
 
@@ -784,18 +1798,21 @@ static void do_scroll(ScrollDirection direction) {
   if (next_page < 0 || next_page >= run->total_metrics) {
     scroll_animation = create_bounce_animation(direction);
   } else {
-    // Get old value if current metric is loaded
+    // Old value if current metric is loaded (read while the slots are unchanged)
     WandbMetric *old_metric = get_current_metric();
-    const char *old_value = old_metric ? old_metric->value : NULL;
+
+    if (get_metric_from_buffer(next_page)) {
+      s_diag.buffer_hits++;
+    } else {
+      s_diag.buffer_misses++;
+    }
 
     s_ui.current_metric_page = next_page;
-    scroll_animation = create_scroll_animation(direction, old_value);
+    s_ui.scroll_delta = delta;
+    scroll_animation = create_scroll_animation(direction, old_metric);
 
-    // Request adjacent metrics for the new position
+    // Request adjacent metrics (and move the push subscription) for the new position
     request_adjacent_metrics();
-
-    // Restart refresh timer for the new metric
-    restart_refresh_timer();
   }
 
   if (s_detail.scroll_animation) {
@@ -806,6 +1823,24 @@ static void do_scroll(ScrollDirection direction) {
   s_detail.scroll_animation = scroll_animation;
 }
 
+// Show metric `index` straight away (picked from the overview), without the slide
+static void jump_to_metric(uint8_t index) {
+  WandbRun *run = &s_data.runs[s_ui.selected_run_index];
+  if (index == s_ui.current_metric_page || (run->total_metrics && index >= run->total_metrics)) return;
+
+  s_ui.scroll_delta = index > s_ui.current_metric_page ? 1 : -1;
+  s_ui.current_metric_page = index;
+  if (get_current_metric()) {
+    s_diag.buffer_hits++;
+  } else {
+    s_diag.buffer_misses++;
+  }
+  update_detail_text();
+
+  cancel_request_timer();
+  do_request_window(NULL);
+}
+
 // Detail Window - Scrub Mode
 // Forward declarations
 static void do_scrub(int direction);
@@ -833,16 +1868,14 @@ static void update_scrub_value_display_interpolated(int32_t index_fixed) {
     history_value = v1 + (v2 - v1) * frac / SCRUB_POSITION_SCALE;
   }
 
-  int decimals;
-  parse_fixed_point(metric->value, &decimals);
-  format_fixed_point(history_value, decimals, s_scrub.value_buffer, sizeof(s_scrub.value_buffer));
+  format_fixed_point(history_value, metric->value_decimals, s_scrub.value_buffer, sizeof(s_scrub.value_buffer));
   text_layer_set_text(s_detail.value_layer, s_scrub.value_buffer);
 }
 
 static void scrub_animation_update(Animation *animation, const AnimationProgress progress) {
   s_scrub.current_index_fixed = lerp_fixed(s_scrub.from_index_fixed, s_scrub.to_index_fixed, progress);
   update_scrub_value_display_interpolated(s_scrub.current_index_fixed);
-  mark_graph_dirty();
+  mark_indicator_dirty();
 }
 
 static void scrub_animation_teardown(Animation *animation) {
@@ -857,7 +1890,7 @@ static void scrub_animation_teardown(Animation *animation) {
   s_scrub.index = s_scrub.current_index_fixed / SCRUB_POSITION_SCALE;
   update_scrub_value_display_interpolated(s_scrub.current_index_fixed);
   update_scrub_name_display();
-  mark_graph_dirty();
+  mark_indicator_dirty();
   s_scrub.animation = NULL;
 }
 
@@ -878,13 +1911,13 @@ static void bounce_animation_update(Animation *animation, const AnimationProgres
   }
 
   update_scrub_value_display_interpolated(s_scrub.current_index_fixed);
-  mark_graph_dirty();
+  mark_indicator_dirty();
 }
 
 static void bounce_animation_teardown(Animation *animation) {
   s_scrub.current_index_fixed = s_scrub.bounce_return;
   update_scrub_value_display_interpolated(s_scrub.current_index_fixed);
-  mark_graph_dirty();
+  mark_indicator_dirty();
   s_scrub.animation = NULL;
 }
 
@@ -948,13 +1981,13 @@ static void wiggle_animation_update(Animation *animation, const AnimationProgres
   }
 
   s_scrub.current_index_fixed = s_scrub.wiggle_start + offset;
-  mark_graph_dirty();
+  mark_indicator_dirty();
 }
 
 static void wiggle_animation_teardown(Animation *animation) {
   s_scrub.current_index_fixed = s_scrub.wiggle_start;
   update_scrub_value_display_interpolated(s_scrub.current_index_fixed);
-  mark_graph_dirty();
+  mark_indicator_dirty();
   s_scrub.animation = NULL;
 }
 
@@ -1070,10 +2103,18 @@ static void detail_select_click_handler(ClickRecognizerRef recognizer, void *con
   }
 }
 
+static void overview_window_push(void);
+
+static void detail_select_long_click_handler(ClickRecognizerRef recognizer, void *context) {
+  if (s_ui.loading || s_scrub.active) return;
+  overview_window_push();
+}
+
 static void detail_click_config_provider(void *context) {
   window_raw_click_subscribe(BUTTON_ID_UP, detail_up_down_handler, detail_up_down_release_handler, NULL);
   window_raw_click_subscribe(BUTTON_ID_DOWN, detail_up_down_handler, detail_up_down_release_handler, NULL);
   window_single_click_subscribe(BUTTON_ID_SELECT, detail_select_click_handler);
+  window_long_click_subscribe(BUTTON_ID_SELECT, 0, detail_select_long_click_handler, NULL);
 }
 
 // Detail Window - Lifecycle
@@ -1093,18 +2134,15 @@ static void detail_window_load(Window *window) {
   s_detail.status_bar = create_status_bar(window_layer);
 
   // Platform-specific layout configuration
+  const int16_t padding = DETAIL_PADDING;
+  const int16_t content_width = bounds.size.w - padding * 2;
+  const int16_t graph_inset = DETAIL_GRAPH_INSET;
   #if defined(PBL_ROUND)
-    const int16_t padding = 30;
     const int16_t name_y = STATUS_BAR_HEIGHT + padding / 2;
-    const int16_t content_width = bounds.size.w - padding * 2;
     const GTextAlignment text_align = GTextAlignmentCenter;
-    const int16_t graph_inset = 10;
   #else
-    const int16_t padding = CONTENT_LEFT_PADDING;
     const int16_t name_y = STATUS_BAR_HEIGHT + padding;
-    const int16_t content_width = bounds.size.w - padding * 2;
     const GTextAlignment text_align = GTextAlignmentLeft;
-    const int16_t graph_inset = 0;
 
     // Create pagination layer (rectangular displays only)
     #if defined(PBL_PLATFORM_EMERY)
@@ -1148,13 +2186,22 @@ static void detail_window_load(Window *window) {
   layer_set_clips(s_detail.graph_layer, false);
   layer_add_child(window_layer, s_detail.graph_layer);
 
+  // Indicator overlay rides along with the graph layer's slide/bounce animations
+  s_detail.indicator_layer = layer_create(GRect(0, 0, s_detail.graph_frame.size.w, s_detail.graph_frame.size.h));
+  layer_set_update_proc(s_detail.indicator_layer, indicator_layer_update_proc);
+  layer_set_clips(s_detail.indicator_layer, false);
+  layer_add_child(s_detail.graph_layer, s_detail.indicator_layer);
+
+  // Falls back to drawing vectors every frame if there is no room for the bitmap
+  s_detail.graph_bitmap = gbitmap_create_blank(s_detail.graph_frame.size,
+    PBL_IF_COLOR_ELSE(GBitmapFormat8Bit, GBitmapFormat1Bit));
+  s_detail.graph_bitmap_valid = false;
+  diag_sample_heap();
+
   // Reset state
   s_detail.scroll_animation = NULL;
   s_scrub.active = false;
 
-  // Start refresh timer for live updates
-  restart_refresh_timer();
-
   // Update display (will show skeleton if metric not loaded)
   update_detail_text();
 }
@@ -1162,10 +2209,14 @@ static void detail_window_load(Window *window) {
 static void detail_window_unload(Window *window) {
   s_scrub.active = false;
 
-  // Cancel refresh timer
-  if (s_refresh_timer) {
-    app_timer_cancel(s_refresh_timer);
-    s_refresh_timer = NULL;
+  // Keep buffered metrics for a quick return, but refresh them when the run is reopened
+  metric_buffer_mark_stale();
+
+  cancel_request_timer();
+
+  // Stop live updates until the detail window is open again
+  if (s_runs_validated) {
+    subscribe_metrics(s_data.runs[s_ui.selected_run_index].list_index, 0, 0);
   }
 
   if (s_detail.scroll_animation) {
@@ -1174,7 +2225,14 @@ static void detail_window_unload(Window *window) {
   }
   text_layer_destroy(s_detail.value_layer);
   text_layer_destroy(s_detail.name_layer);
+  layer_destroy(s_detail.indicator_layer);
+  s_detail.indicator_layer = NULL;
   layer_destroy(s_detail.graph_layer);
+  s_detail.graph_layer = NULL;
+  if (s_detail.graph_bitmap) {
+    gbitmap_destroy(s_detail.graph_bitmap);
+    s_detail.graph_bitmap = NULL;
+  }
   #if !defined(PBL_ROUND)
     text_layer_destroy(s_detail.pagination_layer);
   #endif
@@ -1186,6 +2244,10 @@ static void detail_window_unload(Window *window) {
 // Called when a metric for the current page is received
 static void on_current_metric_ready(void) {
   if (!s_detail.window) return;
+  if (s_diag.detail_opened_ms) {
+    s_diag.open_to_metric_ms = now_ms() - s_diag.detail_opened_ms;
+    s_diag.detail_opened_ms = 0;
+  }
   update_detail_text();
 }
 
@@ -1199,8 +2261,318 @@ static void detail_window_push(void) {
   window_stack_push(s_detail.window, true);
 }
 
+// Overview Window
+// Copy a length-prefixed string from an OVERVIEW_DATA blob, truncating to `size`
+static bool read_overview_string(const uint8_t *data, uint16_t length, uint16_t *pos, char *dst, size_t size) {
+  if (*pos >= length) return false;
+  uint8_t string_length = data[(*pos)++];
+  if (*pos + string_length > length) return false;
+
+  size_t copy = string_length < size - 1 ? string_length : size - 1;
+  memcpy(dst, &data[*pos], copy);
+  dst[copy] = '\0';
+  *pos += string_length;
+  return true;
+}
+
+static uint8_t overview_visible_rows(void) {
+  int16_t rows = layer_get_bounds(s_overview.grid_layer).size.h / OVERVIEW_TILE_HEIGHT;
+  return rows > 0 ? rows : 1;
+}
+
+// Scroll by whole rows to keep the selection visible
+static void overview_scroll_to_selection(void) {
+  uint8_t row = s_overview.selected / OVERVIEW_COLUMNS;
+  uint8_t visible_rows = overview_visible_rows();
+  if (row < s_overview.first_row) {
+    s_overview.first_row = row;
+  } else if (row >= s_overview.first_row + visible_rows) {
+    s_overview.first_row = row - visible_rows + 1;
+  }
+}
+
+// Unpack the tiles in an OVERVIEW_DATA message; the first one sizes the grid
+static void store_overview_tiles(const InboxMessage *message) {
+  if (!s_overview.window) return;
+  const Tuple *data_tuple = message->fields[INBOX_OVERVIEW_DATA];
+  const Tuple *count_tuple = message->fields[INBOX_OVERVIEW_COUNT];
+  const Tuple *first_tuple = message->fields[INBOX_OVERVIEW_FIRST];
+  if (!count_tuple || !first_tuple) return;
+
+  if (!s_overview.counted) {
+    uint8_t count = count_tuple->value->uint8;
+    if (count > MAX_OVERVIEW_TILES) count = MAX_OVERVIEW_TILES;
+    s_overview.tiles = count ? calloc(count, sizeof(OverviewTile)) : NULL;
+    s_overview.num_tiles = s_overview.tiles ? count : 0;
+    s_overview.counted = true;
+    if (s_overview.selected >= s_overview.num_tiles) s_overview.selected = 0;
+    // The window opened on the detail window's metric, which may be past the first screen
+    overview_scroll_to_selection();
+    diag_sample_heap();
+  }
+
+  const uint8_t *data = data_tuple->value->data;
+  uint16_t length = data_tuple->length;
+  uint16_t pos = 0;
+  for (uint8_t index = first_tuple->value->uint8; index < s_overview.num_tiles && pos < length; index++) {
+    OverviewTile *tile = &s_overview.tiles[index];
+    if (!read_overview_string(data, length, &pos, tile->name, sizeof(tile->name)) ||
+        !read_overview_string(data, length, &pos, tile->value, sizeof(tile->value)) ||
+        pos >= length) {
+      break;
+    }
+    uint8_t points = data[pos++];
+    uint16_t spark_bytes = (points + 1) / 2;
+    if (pos + spark_bytes > length) break;
+
+    if (points > OVERVIEW_SPARK_POINTS) points = OVERVIEW_SPARK_POINTS;
+    memcpy(tile->spark, &data[pos], (points + 1) / 2);
+    tile->spark_count = points;
+    tile->ready = true;
+    pos += spark_bytes;
+  }
+  layer_mark_dirty(s_overview.grid_layer);
+}
+
+static void draw_overview_sparkline(GContext *ctx, const OverviewTile *tile, GRect area) {
+  if (tile->spark_count < 2) return;
+
+  GPoint previous = GPointZero;
+  for (int i = 0; i < tile->spark_count; i++) {
+    uint8_t packed = tile->spark[i / 2];
+    uint8_t level = (i % 2 == 0) ? packed >> 4 : packed & 0x0F;
+    GPoint point = GPoint(area.origin.x + i * (area.size.w - 1) / (tile->spark_count - 1),
+                          area.origin.y + (area.size.h - 1) - level * (area.size.h - 1) / OVERVIEW_SPARK_LEVELS);
+    if (i > 0) graphics_draw_line(ctx, previous, point);
+    previous = point;
+  }
+}
+
+static void draw_overview_tile(GContext *ctx, const OverviewTile *tile, GRect frame, bool selected) {
+  GRect inner = GRect(frame.origin.x + OVERVIEW_TILE_PADDING, frame.origin.y + 1,
+                      frame.size.w - OVERVIEW_TILE_PADDING * 2, frame.size.h - 2);
+  GColor foreground = selected ? GColorWhite : GColorBlack;
+  if (selected) {
+    graphics_context_set_fill_color(ctx, GColorBlack);
+    graphics_fill_rect(ctx, inner, 3, GCornersAll);
+  }
+
+  GRect name_area = GRect(inner.origin.x + 2, inner.origin.y - 2, inner.size.w - 4, 16);
+  GRect spark_area = GRect(inner.origin.x + 2, inner.origin.y + 16, inner.size.w - 4, OVERVIEW_SPARK_HEIGHT);
+  GRect value_area = GRect(inner.origin.x + 2, spark_area.origin.y + OVERVIEW_SPARK_HEIGHT - 2, inner.size.w - 4, 16);
+
+  if (!tile->ready) {
+    graphics_context_set_fill_color(ctx, selected ? GColorWhite : PBL_IF_COLOR_ELSE(GColorLightGray, GColorBlack));
+    graphics_fill_rect(ctx, GRect(name_area.origin.x, name_area.origin.y + 6, name_area.size.w * 2 / 3, 6), 0, GCornerNone);
+    graphics_fill_rect(ctx, GRect(value_area.origin.x, value_area.origin.y + 6, value_area.size.w / 3, 6), 0, GCornerNone);
+    return;
+  }
+
+  graphics_context_set_text_color(ctx, foreground);
+  graphics_draw_text(ctx, tile->name, fonts_get_system_font(FONT_KEY_GOTHIC_14), name_area,
+                     GTextOverflowModeTrailingEllipsis, GTextAlignmentLeft, NULL);
+  graphics_context_set_stroke_color(ctx, foreground);
+  draw_overview_sparkline(ctx, tile, spark_area);
+  graphics_draw_text(ctx, tile->value, fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD), value_area,
+                     GTextOverflowModeTrailingEllipsis, GTextAlignmentLeft, NULL);
+}
+
+static void overview_grid_update_proc(Layer *layer, GContext *ctx) {
+  GRect bounds = layer_get_bounds(layer);
+  if (s_overview.num_tiles == 0) {
+    const char *message = s_overview.counted ? "No metrics" : "Loading metrics...";
+    graphics_context_set_text_color(ctx, GColorBlack);
+    graphics_draw_text(ctx, message, fonts_get_system_font(FONT_KEY_GOTHIC_18),
+                       GRect(0, bounds.size.h / 2 - 14, bounds.size.w, 24),
+                       GTextOverflowModeTrailingEllipsis, GTextAlignmentCenter, NULL);
+    return;
+  }
+
+  int16_t tile_width = bounds.size.w / OVERVIEW_COLUMNS;
+  for (int index = s_overview.first_row * OVERVIEW_COLUMNS; index < s_overview.num_tiles; index++) {
+    int16_t y = (index / OVERVIEW_COLUMNS - s_overview.first_row) * OVERVIEW_TILE_HEIGHT;
+    if (y >= bounds.size.h) break;
+    GRect frame = GRect((index % OVERVIEW_COLUMNS) * tile_width, y, tile_width, OVERVIEW_TILE_HEIGHT);
+    draw_overview_tile(ctx, &s_overview.tiles[index], frame, index == s_overview.selected);
+  }
+}
+
+static void overview_move_selection(int delta) {
+  if (s_overview.num_tiles == 0) return;
+  int next = s_overview.selected + delta;
+  if (next < 0 || next >= s_overview.num_tiles) return;
+  s_overview.selected = next;
+  overview_scroll_to_selection();
+  layer_mark_dirty(s_overview.grid_layer);
+}
+
+static void overview_up_handler(ClickRecognizerRef recognizer, void *context) {
+  overview_move_selection(-1);
+}
+
+static void overview_down_handler(ClickRecognizerRef recognizer, void *context) {
+  overview_move_selection(1);
+}
+
+static void overview_select_handler(ClickRecognizerRef recognizer, void *context) {
+  if (s_overview.num_tiles == 0) return;
+  jump_to_metric(s_overview.selected);
+  window_stack_remove(s_overview.window, true);
+}
+
+static void overview_click_config_provider(void *context) {
+  window_single_repeating_click_subscribe(BUTTON_ID_UP, SCRUB_BUTTON_REPEAT_MS, overview_up_handler);
+  window_single_repeating_click_subscribe(BUTTON_ID_DOWN, SCRUB_BUTTON_REPEAT_MS, overview_down_handler);
+  window_single_click_subscribe(BUTTON_ID_SELECT, overview_select_handler);
+}
+
+static void overview_window_load(Window *window) {
+  Layer *window_layer = window_get_root_layer(window);
+  GRect bounds = layer_get_bounds(window_layer);
+
+  s_overview.status_bar = create_status_bar(window_layer);
+
+  // Round screens keep one centered column clear of the bezel
+  const int16_t inset = PBL_IF_ROUND_ELSE(DETAIL_PADDING, 0);
+  s_overview.grid_layer = layer_create(GRect(inset, STATUS_BAR_HEIGHT + 2, bounds.size.w - inset * 2,
+                                             bounds.size.h - STATUS_BAR_HEIGHT - 2));
+  layer_set_update_proc(s_overview.grid_layer, overview_grid_update_proc);
+  layer_add_child(window_layer, s_overview.grid_layer);
+
+  // Start on the metric the detail window shows
+  s_overview.tiles = NULL;
+  s_overview.num_tiles = 0;
+  s_overview.counted = false;
+  s_overview.selected = s_ui.current_metric_page;
+  s_overview.first_row = 0;
+
+  request_overview(s_data.runs[s_ui.selected_run_index].list_index);
+}
+
+static void overview_window_unload(Window *window) {
+  free(s_overview.tiles);
+  s_overview.tiles = NULL;
+  s_overview.num_tiles = 0;
+  layer_destroy(s_overview.grid_layer);
+  s_overview.grid_layer = NULL;
+  status_bar_layer_destroy(s_overview.status_bar);
+  window_destroy(window);
+  s_overview.window = NULL;
+}
+
+static void overview_window_push(void) {
+  if (s_overview.window || !s_runs_validated) return;
+  s_overview.window = window_create();
+  window_set_click_config_provider(s_overview.window, overview_click_config_provider);
+  window_set_window_handlers(s_overview.window, (WindowHandlers) {
+    .load = overview_window_load,
+    .unload = overview_window_unload,
+  });
+  window_stack_push(s_overview.window, true);
+}
+
+// Diagnostics Window
+static void diag_window_render(void) {
+  diag_sample_heap();
+  uint32_t count = s_diag.latency_count;
+  snprintf(s_diag_window.text, sizeof(s_diag_window.text),
+           "Requests: %lu\n"
+           "Latency: %lu avg, %lu-%lu ms\n"
+           "Last: %lu ms\n"
+           "Buffer: %lu hit, %lu miss\n"
+           "Dropped in: %lu, failed out: %lu\n"
+           "First row: %lu ms, metric: %lu ms\n"
+           "Skeleton frames: %lu\n"
+           "Received: %lu B, sent: %lu B\n"
+           "Heap: %lu B, peak %lu B\n"
+           "SELECT: send to phone log\n\n"
+           "PHONE\n%s",
+           (unsigned long)count,
+           (unsigned long)(count ? s_diag.latency_total_ms / count : 0),
+           (unsigned long)s_diag.latency_min_ms, (unsigned long)s_diag.latency_max_ms,
+           (unsigned long)s_diag.latency_last_ms,
+           (unsigned long)s_diag.buffer_hits, (unsigned long)s_diag.buffer_misses,
+           (unsigned long)s_diag.inbox_drops, (unsigned long)s_diag.outbox_failures,
+           (unsigned long)s_diag.first_row_ms, (unsigned long)s_diag.open_to_metric_ms,
+           (unsigned long)s_diag.skeleton_frames,
+           (unsigned long)s_diag.bytes_received, (unsigned long)s_diag.bytes_sent,
+           (unsigned long)heap_bytes_used(), (unsigned long)s_diag.heap_high_water,
+           s_diag_window.phone_trace[0] ? s_diag_window.phone_trace : "Waiting for phone...");
+  text_layer_set_text(s_diag_window.text_layer, s_diag_window.text);
+
+  // Grow the text to fit, then let the scroll layer page through it
+  GRect frame = layer_get_frame(text_layer_get_layer(s_diag_window.text_layer));
+  text_layer_set_size(s_diag_window.text_layer, GSize(frame.size.w, DIAG_TEXT_MAX_HEIGHT));
+  GSize content = text_layer_get_content_size(s_diag_window.text_layer);
+  text_layer_set_size(s_diag_window.text_layer, GSize(frame.size.w, content.h + DIAG_TEXT_BOTTOM_MARGIN));
+  scroll_layer_set_content_size(s_diag_window.scroll_layer,
+                                GSize(frame.size.w, content.h + DIAG_TEXT_BOTTOM_MARGIN));
+}
+
+static void diag_refresh_timer_callback(void *data) {
+  diag_window_render();
+  s_diag_window.refresh_timer = app_timer_register(DIAG_REFRESH_MS, diag_refresh_timer_callback, NULL);
+}
+
+static void diag_select_click_handler(ClickRecognizerRef recognizer, void *context) {
+  request_diagnostics_export();
+  request_trace_summary();
+  vibes_short_pulse();
+}
+
+static void diag_click_config_provider(void *context) {
+  window_single_click_subscribe(BUTTON_ID_SELECT, diag_select_click_handler);
+}
+
+static void diag_window_load(Window *window) {
+  Layer *window_layer = window_get_root_layer(window);
+  GRect bounds = layer_get_bounds(window_layer);
+
+  GRect scroll_bounds = GRect(0, STATUS_BAR_HEIGHT, bounds.size.w, bounds.size.h - STATUS_BAR_HEIGHT);
+  s_diag_window.scroll_layer = scroll_layer_create(scroll_bounds);
+  scroll_layer_set_callbacks(s_diag_window.scroll_layer, (ScrollLayerCallbacks) {
+    .click_config_provider = diag_click_config_provider,
+  });
+  scroll_layer_set_click_config_onto_window(s_diag_window.scroll_layer, window);
+  layer_add_child(window_layer, scroll_layer_get_layer(s_diag_window.scroll_layer));
+
+  GRect text_bounds = GRect(CONTENT_LEFT_PADDING, 0, bounds.size.w - CONTENT_LEFT_PADDING * 2, DIAG_TEXT_MAX_HEIGHT);
+  s_diag_window.text_layer = text_layer_create(text_bounds);
+  text_layer_set_font(s_diag_window.text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+  text_layer_set_text_alignment(s_diag_window.text_layer, PBL_IF_ROUND_ELSE(GTextAlignmentCenter, GTextAlignmentLeft));
+  scroll_layer_add_child(s_diag_window.scroll_layer, text_layer_get_layer(s_diag_window.text_layer));
+
+  s_diag_window.status_bar = create_status_bar(window_layer);
+
+  request_trace_summary();
+  diag_refresh_timer_callback(NULL);
+}
+
+static void diag_window_unload(Window *window) {
+  if (s_diag_window.refresh_timer) {
+    app_timer_cancel(s_diag_window.refresh_timer);
+    s_diag_window.refresh_timer = NULL;
+  }
+  text_layer_destroy(s_diag_window.text_layer);
+  scroll_layer_destroy(s_diag_window.scroll_layer);
+  status_bar_layer_destroy(s_diag_window.status_bar);
+  window_destroy(window);
+  s_diag_window.window = NULL;
+}
+
+static void diag_window_push(void) {
+  if (s_diag_window.window) return;
+  s_diag_window.window = window_create();
+  window_set_window_handlers(s_diag_window.window, (WindowHandlers) {
+    .load = diag_window_load,
+    .unload = diag_window_unload,
+  });
+  window_stack_push(s_diag_window.window, true);
+}
+
 // Main Menu Window
 static char s_header_buffer[MAX_STATE_LENGTH];
+static char s_subtitle_buffer[MAX_RUN_NAME_CHARS + 16];
 
 static void to_uppercase_state(const char *src, char *dst, size_t size) {
   size_t i;
@@ -1211,24 +2583,23 @@ static void to_uppercase_state(const char *src, char *dst, size_t size) {
 }
 
 static uint16_t menu_get_num_sections_callback(MenuLayer *menu_layer, void *data) {
-  return count_unique_states();
+  return s_sections.num_sections;
 }
 
 static uint16_t menu_get_num_rows_callback(MenuLayer *menu_layer, uint16_t section_index, void *data) {
-  const char *state = get_state_for_section(section_index);
-  return state ? count_runs_with_state(state) : 0;
+  const RunSection *section = get_section(section_index);
+  return section ? section->num_rows : 0;
 }
 
 static int16_t menu_get_header_height_callback(MenuLayer *menu_layer, uint16_t section_index, void *data) {
-  const char *state = get_state_for_section(section_index);
-  return state ? 18 : 0;
+  return get_section(section_index) ? 18 : 0;
 }
 
 static void menu_draw_header_callback(GContext *ctx, const Layer *cell_layer, uint16_t section_index, void *data) {
-  const char *state = get_state_for_section(section_index);
-  if (!state) return;
+  const RunSection *section = get_section(section_index);
+  if (!section) return;
 
-  to_uppercase_state(state, s_header_buffer, sizeof(s_header_buffer));
+  to_uppercase_state(s_run_state_names[section->state], s_header_buffer, sizeof(s_header_buffer));
 
   GRect bounds = layer_get_bounds(cell_layer);
   GRect text_bounds = GRect(4, 0, bounds.size.w - 8, bounds.size.h);
@@ -1241,48 +2612,84 @@ static void menu_draw_row_callback(GContext *ctx, const Layer *cell_layer, MenuI
   int8_t run_index = get_run_index_for_section_row(cell_index->section, cell_index->row);
   if (run_index < 0) return;
   WandbRun *run = &s_data.runs[run_index];
-  menu_cell_basic_draw(ctx, cell_layer, run->run_name, run->project_name, NULL);
-}
 
-// Request a single metric by index
-static void request_metric(uint8_t run_index, uint8_t metric_index) {
-  // Try to begin outbox first - don't touch buffer if it fails
-  DictionaryIterator *iter;
-  AppMessageResult result = app_message_outbox_begin(&iter);
-  if (result != APP_MSG_OK) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Failed to begin outbox: %d", result);
+  // Rows restored from the warm-start cache are marked until the phone confirms them
+  if (run->stale) {
+    snprintf(s_subtitle_buffer, sizeof(s_subtitle_buffer), "(cached) %s", run_project_name(run));
+    menu_cell_basic_draw(ctx, cell_layer, run_name(run), s_subtitle_buffer, NULL);
     return;
   }
-
-  // Outbox available - now mark slot as loading
-  int8_t slot = find_slot_for_metric(metric_index);
-  s_metric_buffer.slots[slot].metric_id = metric_index;
-  s_metric_buffer.slots[slot].state = SLOT_LOADING;
-
-  dict_write_uint8(iter, MESSAGE_KEY_FETCH_RUN_INDEX, run_index);
-  dict_write_uint8(iter, MESSAGE_KEY_FETCH_METRIC_INDEX, metric_index);
-  result = app_message_outbox_send();
-  if (result != APP_MSG_OK) {
-    APP_LOG(APP_LOG_LEVEL_ERROR, "Failed to send outbox: %d", result);
-    // Reset slot since send failed
-    s_metric_buffer.slots[slot].state = SLOT_EMPTY;
-  }
+  menu_cell_basic_draw(ctx, cell_layer, run_name(run), run_project_name(run), NULL);
 }
 
 static void menu_select_callback(MenuLayer *menu_layer, MenuIndex *cell_index, void *data) {
   int8_t run_index = get_run_index_for_section_row(cell_index->section, cell_index->row);
   if (run_index < 0) return;
   s_ui.selected_run_index = run_index;
+
+  // Returning to the last viewed run resumes at its page, showing buffered metrics right away
+  if (run_index == s_buffered_run_index && s_data.runs[run_index].total_metrics > 0) {
+    do_request_window(NULL);
+    detail_window_push();
+    return;
+  }
+
+  s_buffered_run_index = run_index;
+  snapshot_buffered_run();
+  s_diag.detail_opened_ms = now_ms();
   s_ui.current_metric_page = 0;
+  s_ui.scroll_delta = 1;
 
-  // Clear buffer and request first metric directly (no debounce needed for initial load)
-  // Adjacent metrics will be requested once we learn total_metrics from the response
+  // Clear buffer and request the first window directly (no debounce needed for initial load);
+  // JS trims the range to the run's metric count
+  request_queue_clear();
   metric_buffer_clear();
-  request_metric(s_ui.selected_run_index, 0);
+  do_request_window(NULL);
 
   detail_window_push();
 }
 
+// Hidden: long-press any run to see why things are slow
+static void menu_select_long_callback(MenuLayer *menu_layer, MenuIndex *cell_index, void *data) {
+  diag_window_push();
+}
+
+// The highlight settled on a run: let the phone warm up for it, unless it is already buffered
+static void run_prefetch_timer_callback(void *context) {
+  s_main.prefetch_timer = NULL;
+  MenuIndex index = menu_layer_get_selected_index(s_main.menu);
+  int8_t run_index = get_run_index_for_section_row(index.section, index.row);
+  if (run_index < 0 || run_index == s_buffered_run_index || !s_runs_validated) return;
+
+  WandbRun *run = &s_data.runs[run_index];
+  if (run->stale || run->state == RUN_STATE_REMOVED) return;
+  request_run_prefetch(run->list_index);
+}
+
+static void menu_selection_changed_callback(MenuLayer *menu_layer, MenuIndex new_index,
+    MenuIndex old_index, void *data) {
+  const RunSection *section = get_section(new_index.section);
+  int8_t run_index = get_run_index_for_section_row(new_index.section, new_index.row);
+  if (!section || run_index < 0) return;
+  s_ui.menu_list_index = s_data.runs[run_index].list_index;
+
+  // Rows are grouped by state and removed runs are hidden, so nearness to the ends is by menu
+  // position among the visible rows, not list index; pages still continue from the loaded ends
+  uint8_t position = section->first_row + new_index.row;
+  if (s_runs_has_more && position + RUNS_PAGE_MARGIN >= get_num_visible_runs()) {
+    request_runs_page(s_data.runs[s_data.num_runs - 1].list_index + 1, false);
+  } else if (s_data.runs[0].list_index > 0 && position < RUNS_PAGE_MARGIN) {
+    request_runs_page(s_data.runs[0].list_index, true);
+  }
+
+  // Scrolling past rows shouldn't hint each of them
+  if (s_main.prefetch_timer) {
+    app_timer_reschedule(s_main.prefetch_timer, RUN_PREFETCH_DEBOUNCE_MS);
+  } else {
+    s_main.prefetch_timer = app_timer_register(RUN_PREFETCH_DEBOUNCE_MS, run_prefetch_timer_callback, NULL);
+  }
+}
+
 static void main_window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
   GRect bounds = layer_get_bounds(window_layer);
@@ -1297,6 +2704,8 @@ static void main_window_load(Window *window) {
     .draw_header = menu_draw_header_callback,
     .draw_row = menu_draw_row_callback,
     .select_click = menu_select_callback,
+    .select_long_click = menu_select_long_callback,
+    .selection_changed = menu_selection_changed_callback,
   });
 
   menu_layer_set_click_config_onto_window(s_main.menu, window);
@@ -1332,6 +2741,10 @@ static void main_window_unload(Window *window) {
     app_timer_cancel(s_main.loading_timer);
     s_main.loading_timer = NULL;
   }
+  if (s_main.prefetch_timer) {
+    app_timer_cancel(s_main.prefetch_timer);
+    s_main.prefetch_timer = NULL;
+  }
   menu_layer_destroy(s_main.menu);
   text_layer_destroy(s_main.loading_layer);
   status_bar_layer_destroy(s_main.status_bar);
@@ -1356,183 +2769,782 @@ static void main_loading_timer_callback(void *data) {
   text_layer_set_text(s_main.loading_layer, "Could not load runs. Check your API key.");
 }
 
-// AppMessage Handling
-static void inbox_received_callback(DictionaryIterator *iter, void *context) {
-  // Check for refresh interval setting from config
-  Tuple *refresh_tuple = dict_find(iter, MESSAGE_KEY_refreshInterval);
-  if (refresh_tuple) {
-    // Clay sends select values as strings, parse to integer
-    uint32_t new_interval = atoi(refresh_tuple->value->cstring);
-    if (new_interval >= 5000) {  // Minimum 5 seconds
-      s_refresh_interval_ms = new_interval;
-      persist_write_int(PERSIST_KEY_REFRESH_INTERVAL, s_refresh_interval_ms);
+// Called once the phone has delivered the full runs list
+static void on_runs_list_complete(void) {
+  // Drop cached rows the fresh list no longer has
+  while (s_data.num_runs > s_received_runs_count) {
+    run_release_strings(&s_data.runs[--s_data.num_runs]);
+  }
+  s_runs_validated = true;
+  rebuild_run_sections();
+
+  // Follow the buffered run to its new position, or drop its metrics if it's gone
+  if (s_buffered_run_index >= 0) {
+    int8_t new_index = -1;
+    for (int i = 0; i < s_data.num_runs; i++) {
+      if (s_data.runs[i].state != RUN_STATE_REMOVED &&
+          strcmp(run_name(&s_data.runs[i]), s_buffered_run_snapshot.run_name) == 0 &&
+          strcmp(run_project_name(&s_data.runs[i]), s_buffered_run_snapshot.project_name) == 0) {
+        new_index = i;
+        break;
+      }
+    }
+
+    if (new_index >= 0) {
+      s_data.runs[new_index].total_metrics = s_buffered_run_snapshot.total_metrics;
+      s_buffered_run_index = new_index;
+      s_ui.selected_run_index = new_index;
+    } else {
+      s_buffered_run_index = -1;
+      metric_buffer_clear();
+      if (s_detail.window) {
+        window_stack_remove(s_detail.window, true);
+      }
     }
   }
 
-  // Check for RUNS_COUNT (sent with first message)
-  Tuple *count_tuple = dict_find(iter, MESSAGE_KEY_RUNS_COUNT);
-  if (count_tuple) {
-    s_expected_runs_count = count_tuple->value->uint8;
-    s_data.num_runs = 0;  // Reset for new data
+  hide_main_loading();
 
-    // Handle 0 runs case immediately
-    if (s_expected_runs_count == 0) {
-      hide_main_loading();
+  // Requests made against the cached list were held back; issue them now
+  if (s_detail.window) {
+    request_adjacent_metrics();
+  }
+}
+
+// Runs window paging
+// Drop the run in `slot` from the window, shifting later rows (and indices into them) down.
+// The run whose detail window is open is never evicted.
+static bool evict_run(uint8_t slot) {
+  if (slot == s_buffered_run_index) {
+    if (s_detail.window) return false;
+    s_buffered_run_index = -1;
+    request_queue_clear();
+    metric_buffer_clear();
+  }
+
+  run_release_strings(&s_data.runs[slot]);
+  memmove(&s_data.runs[slot], &s_data.runs[slot + 1], (s_data.num_runs - slot - 1) * sizeof(WandbRun));
+  s_data.num_runs--;
+  if (s_buffered_run_index > slot) s_buffered_run_index--;
+  if (s_ui.selected_run_index > slot) s_ui.selected_run_index--;
+  return true;
+}
+
+// Make room by dropping the run at the end of the window away from where rows are arriving
+static bool evict_far_run(bool appending) {
+  if (s_data.num_runs == 0) return false;
+  if (!evict_run(appending ? 0 : s_data.num_runs - 1)) return false;
+  if (!appending) s_runs_has_more = true;
+  return true;
+}
+
+// Add a paged-in row at whichever end of the window it extends, evicting from the far end
+// when the window or string table is full. Rows that don't touch the window (the selection
+// moved on meanwhile) are dropped.
+static void merge_run_row(WandbRun *row, const char *name, uint8_t phone_id, const char *project_name) {
+  bool appending = s_data.num_runs == 0 || row->list_index == s_data.runs[s_data.num_runs - 1].list_index + 1;
+  if (!appending && row->list_index + 1 != s_data.runs[0].list_index) return;
+
+  while (s_data.num_runs >= MAX_WANDB_RUNS) {
+    if (!evict_far_run(appending)) return;
+  }
+  while (!run_intern_strings(row, name, phone_id, project_name)) {
+    if (!evict_far_run(appending)) return;
+  }
+
+  if (appending) {
+    s_data.runs[s_data.num_runs++] = *row;
+    return;
+  }
+  memmove(&s_data.runs[1], &s_data.runs[0], s_data.num_runs * sizeof(WandbRun));
+  s_data.runs[0] = *row;
+  s_data.num_runs++;
+  if (s_buffered_run_index >= 0) s_buffered_run_index++;
+  s_ui.selected_run_index++;
+}
+
+// Store row `s_received_runs_count` of a fresh list over whatever was cached there.
+// Returns false if its strings don't fit even with the rest of the cached rows gone.
+static bool store_list_row(WandbRun *row, const char *name, uint8_t phone_id, const char *project_name) {
+  uint8_t slot = s_received_runs_count;
+  if (slot < s_data.num_runs) run_release_strings(&s_data.runs[slot]);
+
+  bool stored = run_intern_strings(row, name, phone_id, project_name);
+  while (!stored && s_data.num_runs > slot + 1) {
+    run_release_strings(&s_data.runs[--s_data.num_runs]);
+    stored = run_intern_strings(row, name, phone_id, project_name);
+  }
+  if (!stored) {
+    s_data.num_runs = slot;
+    return false;
+  }
+
+  s_data.runs[slot] = *row;
+
+  // Cached rows stay visible while fresh ones replace them
+  if (slot >= s_data.num_runs) s_data.num_runs = slot + 1;
+  return true;
+}
+
+// Reload the runs menu, keeping the highlight on the same run as rows come and go
+static void reload_runs_menu(void) {
+  menu_layer_reload_data(s_main.menu);
+  for (int i = 0; i < s_data.num_runs; i++) {
+    if (s_data.runs[i].list_index == s_ui.menu_list_index) {
+      menu_layer_set_selected_index(s_main.menu, get_menu_index_for_run(i), MenuRowAlignNone, false);
       return;
     }
   }
+}
 
-  // Get run data
-  Tuple *name_tuple = dict_find(iter, MESSAGE_KEY_RUN_NAME);
-  Tuple *source_tuple = dict_find(iter, MESSAGE_KEY_RUN_OWNER);
-  Tuple *state_tuple = dict_find(iter, MESSAGE_KEY_RUN_STATE);
+static void on_runs_page_complete(void) {
+  s_runs_page_pending = false;
+  if (!s_main.loading) reload_runs_menu();
+}
+
+// Runs list revalidation
+static int find_run_slot(uint16_t list_index) {
+  for (int i = 0; i < s_data.num_runs; i++) {
+    if (s_data.runs[i].list_index == list_index) return i;
+  }
+  return -1;
+}
 
-  if (name_tuple && source_tuple && state_tuple && s_data.num_runs < MAX_WANDB_RUNS) {
-    WandbRun *run = &s_data.runs[s_data.num_runs];
+// Give the run in `slot` a new name; it keeps the old one if the string table is full
+static void rename_run(uint8_t slot, const char *name) {
+  WandbRun *run = &s_data.runs[slot];
+  uint16_t old_offset = run->name_offset;
+  uint16_t new_offset;
+  if (!strings_add(name, &new_offset)) return;
+  run->name_offset = new_offset;
+  strings_remove(old_offset);
+}
+
+// Apply a RUNS_PATCH row: the phone re-fetched its runs list and this row changed state or
+// name, was added at the end, or was removed. List indices never move, so the row is patched
+// where it sits; rows outside the window only matter when they extend it.
+static void apply_run_patch(const InboxMessage *message) {
+  const Tuple *index_tuple = message->fields[INBOX_RUN_INDEX];
+  const Tuple *name_tuple = message->fields[INBOX_RUN_NAME];
+  const Tuple *project_tuple = message->fields[INBOX_RUN_PROJECT];
+  const Tuple *state_tuple = message->fields[INBOX_RUN_STATE];
+  const Tuple *owner_tuple = message->fields[INBOX_RUN_OWNER];
+  if (!index_tuple || !name_tuple || !project_tuple || !state_tuple) return;
+
+  // A list still streaming in already has the phone's current rows
+  if (!s_runs_validated) return;
+
+  const char *name = name_tuple->value->cstring;
+  WandbRun row = {
+    .list_index = index_tuple->value->uint16,
+    .state = parse_run_state(state_tuple->value->cstring),
+  };
+
+  int slot = find_run_slot(row.list_index);
+  if (slot < 0) {
+    uint16_t end = s_data.num_runs > 0 ? s_data.runs[s_data.num_runs - 1].list_index + 1 : 0;
+    if (row.list_index == end && !s_runs_has_more) {
+      merge_run_row(&row, name, project_tuple->value->uint8, owner_tuple ? owner_tuple->value->cstring : NULL);
+    } else if (row.list_index >= end) {
+      // Paged in when the menu gets there
+      s_runs_has_more = true;
+      return;
+    } else {
+      return;
+    }
+  } else {
+    WandbRun *run = &s_data.runs[slot];
+    if (strncmp(run_name(run), name, MAX_RUN_NAME_CHARS - 1) != 0) rename_run(slot, name);
+    run->state = row.state;
 
-    strncpy(run->run_name, name_tuple->value->cstring, MAX_RUN_NAME_CHARS - 1);
-    run->run_name[MAX_RUN_NAME_CHARS - 1] = '\0';
+    // The run on screen is gone; its metrics can't be fetched any more
+    if (row.state == RUN_STATE_REMOVED && slot == s_buffered_run_index && s_detail.window) {
+      window_stack_remove(s_detail.window, true);
+    }
+  }
 
-    strncpy(run->project_name, source_tuple->value->cstring, MAX_RUN_NAME_CHARS - 1);
-    run->project_name[MAX_RUN_NAME_CHARS - 1] = '\0';
+  rebuild_run_sections();
+  if (!s_main.loading) reload_runs_menu();
+}
 
-    strncpy(run->state, state_tuple->value->cstring, MAX_STATE_LENGTH - 1);
-    run->state[MAX_STATE_LENGTH - 1] = '\0';
-    run->total_metrics = 0;
+// Warm-start cache: blobs are split across consecutive keys to fit PERSIST_DATA_MAX_LENGTH
+static void persist_write_chunked(uint32_t base_key, const void *data, size_t size) {
+  const uint8_t *bytes = data;
+  for (size_t offset = 0; offset < size; offset += PERSIST_DATA_MAX_LENGTH) {
+    size_t chunk = size - offset < PERSIST_DATA_MAX_LENGTH ? size - offset : PERSIST_DATA_MAX_LENGTH;
+    persist_write_data(base_key + offset / PERSIST_DATA_MAX_LENGTH, bytes + offset, chunk);
+  }
+}
 
-    s_data.num_runs++;
+static bool persist_read_chunked(uint32_t base_key, void *data, size_t size) {
+  uint8_t *bytes = data;
+  for (size_t offset = 0; offset < size; offset += PERSIST_DATA_MAX_LENGTH) {
+    size_t chunk = size - offset < PERSIST_DATA_MAX_LENGTH ? size - offset : PERSIST_DATA_MAX_LENGTH;
+    int read = persist_read_data(base_key + offset / PERSIST_DATA_MAX_LENGTH, bytes + offset, chunk);
+    if (read != (int)chunk) return false;
+  }
+  return true;
+}
 
-    // Check if all runs received
-    if (s_data.num_runs >= s_expected_runs_count) {
-      hide_main_loading();
+static void warm_cache_save(void) {
+  // Nothing to restore (e.g. every run was deleted); drop the header so the old runs don't come back
+  if (s_data.num_runs == 0) {
+    persist_delete(PERSIST_KEY_CACHE_HEADER);
+    return;
+  }
+
+  WarmCacheHeader header = {
+    .version = CACHE_FORMAT_VERSION,
+    .num_runs = s_data.num_runs,
+    .run_record_size = sizeof(WandbRun),
+    .slot_record_size = sizeof(WandbMetric),
+    .strings_used = s_data.strings_used,
+    .metric_run_index = s_buffered_run_index,
+    .metric_page = s_ui.current_metric_page,
+    .num_slots = 0,
+  };
+
+  persist_write_chunked(PERSIST_KEY_CACHE_RUNS_BASE, s_data.runs, s_data.num_runs * sizeof(WandbRun));
+  persist_write_chunked(PERSIST_KEY_CACHE_STRINGS_BASE, s_data.projects, CACHE_STRINGS_BLOB_SIZE(s_data.strings_used));
+
+  // Only READY slots are worth restoring; pack those nearest the last page from the first slot key
+  for (int distance = 0; s_buffered_run_index >= 0 && distance < s_metric_buffer.num_slots; distance++) {
+    for (int i = 0; i < s_metric_buffer.num_slots && header.num_slots < CACHE_MAX_SLOTS; i++) {
+      MetricBufferSlot *slot = &s_metric_buffer.slots[i];
+      int offset = slot->metric_id - s_ui.current_metric_page;
+      if (slot->state != SLOT_READY || (offset != distance && offset != -distance)) continue;
+      persist_write_chunked(PERSIST_KEY_CACHE_SLOTS_BASE + header.num_slots * PERSIST_KEYS_PER_SLOT,
+                            &slot->metric, sizeof(WandbMetric));
+      header.slot_metric_ids[header.num_slots] = slot->metric_id;
+      header.num_slots++;
     }
   }
 
-  // Check for METRICS_COUNT (sent with metric messages)
-  Tuple *metrics_count_tuple = dict_find(iter, MESSAGE_KEY_METRICS_COUNT);
-  if (metrics_count_tuple) {
-    WandbRun *run = &s_data.runs[s_ui.selected_run_index];
-    uint8_t new_total = metrics_count_tuple->value->uint8;
-
-    // If we just learned the total, request adjacent metrics
-    // (current metric already arrived with this message)
-    if (run->total_metrics == 0 && new_total > 0) {
-      run->total_metrics = new_total;
-      s_request_next_timer = app_timer_register(ADJACENT_METRIC_STAGGER_MS, do_request_next, NULL);
-      s_request_prev_timer = app_timer_register(ADJACENT_METRIC_STAGGER_MS * 2, do_request_prev, NULL);
-    } else {
-      run->total_metrics = new_total;
+  // Header last, so a partial write leaves the previous header pointing at complete data
+  persist_write_data(PERSIST_KEY_CACHE_HEADER, &header, sizeof(header));
+}
+
+// A restored metric is only used if nothing in it can index past its arrays
+static bool cached_metric_valid(const WandbMetric *metric, int16_t metric_id) {
+  return metric_id >= 0 && metric_id <= UINT8_MAX &&
+         metric->history_count <= MAX_GRAPH_HISTORY_POINTS &&
+         metric->value_decimals <= MAX_VALUE_DECIMALS &&
+         memchr(metric->name, '\0', sizeof(metric->name)) != NULL &&
+         memchr(metric->value, '\0', sizeof(metric->value)) != NULL;
+}
+
+// Restore runs and metrics from the last session; returns true if the menu can show immediately
+static bool warm_cache_load(void) {
+  WarmCacheHeader header;
+  if (persist_read_data(PERSIST_KEY_CACHE_HEADER, &header, sizeof(header)) != (int)sizeof(header)) {
+    return false;
+  }
+  if (header.version != CACHE_FORMAT_VERSION ||
+      header.run_record_size != sizeof(WandbRun) ||
+      header.slot_record_size != sizeof(WandbMetric) ||
+      header.num_runs == 0 || header.num_runs > MAX_WANDB_RUNS ||
+      header.strings_used == 0 || header.strings_used > RUN_STRINGS_SIZE) {
+    return false;
+  }
+
+  // Read in place; a blob that fails part way through is wiped so no half-read runs or
+  // strings are left behind for the cold start
+  bool valid = persist_read_chunked(PERSIST_KEY_CACHE_RUNS_BASE, s_data.runs, header.num_runs * sizeof(WandbRun)) &&
+               persist_read_chunked(PERSIST_KEY_CACHE_STRINGS_BASE, s_data.projects,
+                                    CACHE_STRINGS_BLOB_SIZE(header.strings_used));
+  for (int i = 0; valid && i < header.num_runs; i++) {
+    WandbRun *run = &s_data.runs[i];
+    if (run->name_offset >= header.strings_used ||
+        (run->project != RUN_PROJECT_NONE && run->project >= MAX_RUN_PROJECTS)) {
+      valid = false;
+      break;
     }
+    run->stale = true;
+    if (run->state >= RUN_STATE_COUNT) run->state = RUN_STATE_OTHER;
   }
+  if (!valid) {
+    memset(&s_data, 0, sizeof(s_data));
+    return false;
+  }
+  s_data.num_runs = header.num_runs;
+  s_data.strings_used = header.strings_used;
+  s_data.strings[s_data.strings_used - 1] = '\0';
 
-  // Get metric data with index
-  Tuple *metric_index_tuple = dict_find(iter, MESSAGE_KEY_METRIC_INDEX);
-  Tuple *metric_name_tuple = dict_find(iter, MESSAGE_KEY_METRIC_NAME);
-  Tuple *metric_value_tuple = dict_find(iter, MESSAGE_KEY_METRIC_VALUE);
-  Tuple *metric_history_tuple = dict_find(iter, MESSAGE_KEY_METRIC_HISTORY);
+  // Project IDs are handed out per phone session; cached entries are matched by name again
+  for (int i = 0; i < MAX_RUN_PROJECTS; i++) {
+    s_data.projects[i].phone_id = RUN_PROJECT_NONE;
+  }
+  rebuild_run_sections();
 
-  if (metric_index_tuple && metric_name_tuple && metric_value_tuple) {
-    uint8_t metric_index = metric_index_tuple->value->uint8;
+  if (header.metric_run_index < 0 || header.metric_run_index >= s_data.num_runs) return true;
 
-    // Find the slot for this metric
-    int8_t slot = -1;
-    for (int i = 0; i < METRIC_SLIDING_BUFFER_SLOTS; i++) {
-      if (s_metric_buffer.slots[i].metric_id == metric_index) {
-        slot = i;
-        break;
-      }
+  uint8_t num_slots = header.num_slots < s_metric_buffer.num_slots ? header.num_slots : s_metric_buffer.num_slots;
+  for (int i = 0; i < num_slots; i++) {
+    MetricBufferSlot *slot = &s_metric_buffer.slots[i];
+    if (!persist_read_chunked(PERSIST_KEY_CACHE_SLOTS_BASE + i * PERSIST_KEYS_PER_SLOT,
+                              &slot->metric, sizeof(WandbMetric)) ||
+        !cached_metric_valid(&slot->metric, header.slot_metric_ids[i])) {
+      metric_buffer_init();
+      return true;
+    }
+    slot->metric_id = header.slot_metric_ids[i];
+    slot->state = SLOT_READY;
+    slot->stale = true;
+    invalidate_graph_geometry(slot);
+  }
+
+  s_buffered_run_index = header.metric_run_index;
+  s_ui.current_metric_page = header.metric_page;
+  return true;
+}
+
+// Append a point, shifting the oldest one out when at capacity
+static void history_append(WandbMetric *metric, int64_t value) {
+  if (metric->history_count >= MAX_GRAPH_HISTORY_POINTS) {
+    for (int i = 0; i < MAX_GRAPH_HISTORY_POINTS - 1; i++) {
+      metric->history[i] = metric->history[i + 1];
     }
+    metric->history[MAX_GRAPH_HISTORY_POINTS - 1] = value;
+  } else {
+    metric->history[metric->history_count] = value;
+    metric->history_count++;
+  }
+}
+
+// Drop points from the front of the history
+static void history_drop_front(WandbMetric *metric, uint8_t count) {
+  if (count > metric->history_count) count = metric->history_count;
+  memmove(metric->history, &metric->history[count], (metric->history_count - count) * sizeof(int64_t));
+  metric->history_count -= count;
+}
+
+static int64_t read_int64_le(const uint8_t *bytes) {
+  uint32_t low = bytes[0] |
+    (bytes[1] << 8) |
+    (bytes[2] << 16) |
+    ((uint32_t)bytes[3] << 24);
+  uint32_t high = bytes[4] |
+    (bytes[5] << 8) |
+    (bytes[6] << 16) |
+    ((uint32_t)bytes[7] << 24);
+  return (int64_t)(((uint64_t)high << 32) | low);
+}
+
+// Decode packed little-endian int64 points and append them to the history
+static void history_append_int64(WandbMetric *metric, const uint8_t *bytes, uint16_t length) {
+  uint16_t num_points = length / 8;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // The payload is already the history's in-memory layout: make room, then copy it in whole
+  if (num_points > MAX_GRAPH_HISTORY_POINTS) {
+    bytes += (num_points - MAX_GRAPH_HISTORY_POINTS) * 8;
+    num_points = MAX_GRAPH_HISTORY_POINTS;
+  }
+  int overflow = metric->history_count + num_points - MAX_GRAPH_HISTORY_POINTS;
+  if (overflow > 0) history_drop_front(metric, overflow);
+  memcpy(&metric->history[metric->history_count], bytes, num_points * sizeof(int64_t));
+  metric->history_count += num_points;
+#else
+  for (int i = 0; i < num_points; i++) {
+    history_append(metric, read_int64_le(&bytes[i * 8]));
+  }
+#endif
+}
+
+// Decode uint8/uint16 samples quantized over a [min, max] header and append them
+static void history_append_quantized(WandbMetric *metric, const uint8_t *bytes, uint16_t length,
+    uint8_t sample_bytes) {
+  if (length < HISTORY_QUANTIZED_HEADER_BYTES) return;
+
+  int64_t min = read_int64_le(bytes);
+  int64_t range = read_int64_le(bytes + 8) - min;
+  int32_t levels = (sample_bytes == 1) ? UINT8_MAX : UINT16_MAX;
+  bytes += HISTORY_QUANTIZED_HEADER_BYTES;
+  length -= HISTORY_QUANTIZED_HEADER_BYTES;
+
+  uint16_t num_points = length / sample_bytes;
+  for (int i = 0; i < num_points; i++) {
+    uint16_t q = (sample_bytes == 1) ? bytes[i] : (bytes[i * 2] | (bytes[i * 2 + 1] << 8));
+    history_append(metric, min + (range * q + levels / 2) / levels);
+  }
+}
+
+// Decode zigzag varint deltas (the first delta is relative to zero) and append them
+static void history_append_varint(WandbMetric *metric, const uint8_t *bytes, uint16_t length) {
+  int64_t value = 0;
+  uint64_t zigzag = 0;
+  uint8_t shift = 0;
+
+  for (int i = 0; i < length; i++) {
+    zigzag |= (uint64_t)(bytes[i] & 0x7F) << shift;
+    if (bytes[i] & 0x80) {
+      shift += 7;
+      if (shift > 63) return;  // Malformed
+      continue;
+    }
+    value += (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+    history_append(metric, value);
+    zigzag = 0;
+    shift = 0;
+  }
+}
+
+// Decode a METRIC_HISTORY payload in any format and append its points
+static void history_append_packed(WandbMetric *metric, const uint8_t *bytes, uint16_t length) {
+  if (length == 0) return;
+
+  uint8_t format = bytes[0];
+  bytes++;
+  length--;
 
-    // If not found (race condition), assign a slot
-    if (slot < 0) {
-      slot = find_slot_for_metric(metric_index);
-      s_metric_buffer.slots[slot].metric_id = metric_index;
+  switch (format) {
+    case HISTORY_FORMAT_INT64: history_append_int64(metric, bytes, length); break;
+    case HISTORY_FORMAT_Q8: history_append_quantized(metric, bytes, length, 1); break;
+    case HISTORY_FORMAT_Q16: history_append_quantized(metric, bytes, length, 2); break;
+    case HISTORY_FORMAT_VARINT: history_append_varint(metric, bytes, length); break;
+    default:
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Unknown history format: %d", format);
+      break;
+  }
+}
+
+// Decode METRIC_VALUE and format it for the value layer, once per receipt
+static void store_metric_value(WandbMetric *metric, const Tuple *value_tuple) {
+  const uint8_t *data = value_tuple->value->data;
+  metric->has_value = value_tuple->length >= METRIC_VALUE_BYTES && data[0] <= MAX_VALUE_DECIMALS;
+  if (!metric->has_value) {
+    metric->value_fixed = 0;
+    metric->value_decimals = 0;
+    strncpy(metric->value, "---", MAX_METRIC_VALUE_CHARS);
+    return;
+  }
+
+  metric->value_decimals = data[0];
+  metric->value_fixed = read_int64_le(&data[1]);
+  format_fixed_point(metric->value_fixed, metric->value_decimals, metric->value, MAX_METRIC_VALUE_CHARS);
+}
+
+// Copy a cstring tuple, bounded by both the tuple and the destination
+static void copy_tuple_string(char *dst, size_t size, const Tuple *tuple) {
+  size_t length = tuple->length;
+  if (length > size - 1) length = size - 1;
+  memcpy(dst, tuple->value->cstring, length);
+  dst[length] = '\0';
+}
+
+// Decode one batched metric entry into its buffer slot; returns false when the entry is incomplete.
+// Entries carrying METRIC_HISTORY_DROP are deltas against the history the slot already holds:
+// drop that many points from the front, then append METRIC_HISTORY. Deltas omit the name.
+static bool store_metric_entry(const Tuple *const fields[METRIC_FIELD_COUNT]) {
+  const Tuple *metric_index_tuple = fields[METRIC_FIELD_INDEX];
+  const Tuple *metric_name_tuple = fields[METRIC_FIELD_NAME];
+  const Tuple *metric_value_tuple = fields[METRIC_FIELD_VALUE];
+  const Tuple *metric_history_tuple = fields[METRIC_FIELD_HISTORY];
+  const Tuple *history_drop_tuple = fields[METRIC_FIELD_HISTORY_DROP];
+  const Tuple *last_step_tuple = fields[METRIC_FIELD_LAST_STEP];
+
+  if (!metric_index_tuple || !metric_value_tuple) return false;
+  if (!metric_name_tuple && !history_drop_tuple) return false;
+
+  uint8_t metric_index = metric_index_tuple->value->uint8;
+  diag_metric_received(metric_index);
+
+  // Find the slot for this metric
+  int8_t slot = -1;
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
+    if (s_metric_buffer.slots[i].metric_id == metric_index) {
+      slot = i;
+      break;
     }
+  }
+
+  // A delta needs the history it was computed against; without it, wait for the next full send
+  if (history_drop_tuple && (slot < 0 || s_metric_buffer.slots[slot].state != SLOT_READY)) {
+    return true;
+  }
+
+  // If not found (race condition), assign a slot
+  if (slot < 0) {
+    slot = find_slot_for_metric(metric_index);
+    s_metric_buffer.slots[slot].metric_id = metric_index;
+  }
 
-    MetricBufferSlot *buf_slot = &s_metric_buffer.slots[slot];
-    WandbMetric *metric = &buf_slot->metric;
+  MetricBufferSlot *buf_slot = &s_metric_buffer.slots[slot];
+  WandbMetric *metric = &buf_slot->metric;
 
-    strncpy(metric->name, metric_name_tuple->value->cstring, MAX_RUN_NAME_CHARS - 1);
-    metric->name[MAX_RUN_NAME_CHARS - 1] = '\0';
+  if (metric_name_tuple) copy_tuple_string(metric->name, sizeof(metric->name), metric_name_tuple);
 
-    strncpy(metric->value, metric_value_tuple->value->cstring, MAX_METRIC_VALUE_CHARS - 1);
-    metric->value[MAX_METRIC_VALUE_CHARS - 1] = '\0';
+  store_metric_value(metric, metric_value_tuple);
 
-    // Parse history if present (packed int64 array)
+  if (history_drop_tuple) {
+    // Remove the appended current value so the delta lines up with the phone's samples
+    if (metric->has_live_point) {
+      metric->history_count--;
+    }
+    history_drop_front(metric, history_drop_tuple->value->uint8);
+  } else {
     metric->history_count = 0;
-    if (metric_history_tuple && metric_history_tuple->length > 0) {
-      uint8_t *bytes = metric_history_tuple->value->data;
-      uint16_t num_points = metric_history_tuple->length / 8;
-      if (num_points > MAX_GRAPH_HISTORY_POINTS) num_points = MAX_GRAPH_HISTORY_POINTS;
-
-      for (int i = 0; i < num_points; i++) {
-        // Little-endian int64
-        uint32_t low = bytes[i * 8] |
-          (bytes[i * 8 + 1] << 8) |
-          (bytes[i * 8 + 2] << 16) |
-          (bytes[i * 8 + 3] << 24);
-        uint32_t high = bytes[i * 8 + 4] |
-          (bytes[i * 8 + 5] << 8) |
-          (bytes[i * 8 + 6] << 16) |
-          (bytes[i * 8 + 7] << 24);
-        metric->history[i] = (int64_t)(((uint64_t)high << 32) | low);
-      }
-      metric->history_count = num_points;
+  }
+  metric->has_live_point = false;
+
+  // Parse history if present (format byte + packed points)
+  if (metric_history_tuple && metric_history_tuple->length > 0) {
+    history_append_packed(metric, metric_history_tuple->value->data, metric_history_tuple->length);
+  }
+  metric->last_step = last_step_tuple ? last_step_tuple->value->int32 : -1;
+
+  // Check if current value differs from last history point and add it
+  // Compare at the display precision to avoid false positives from rounding
+  if (metric->has_value && metric->history_count > 0) {
+    int64_t last_history = metric->history[metric->history_count - 1];
+    if (fixed_point_at_decimals(metric->value_fixed, metric->value_decimals) !=
+        fixed_point_at_decimals(last_history, metric->value_decimals)) {
+      history_append(metric, metric->value_fixed);
+      metric->has_live_point = true;
     }
+  }
 
-    // Check if current value differs from last history point and add it
-    // Compare at the display precision to avoid false positives from rounding
-    if (metric->history_count > 0) {
-      int decimals;
-      int64_t current_value = (int64_t)parse_fixed_point(metric->value, &decimals);
-      int64_t last_history = metric->history[metric->history_count - 1];
-
-      // Format both values at the same precision and compare
-      char current_str[MAX_METRIC_VALUE_CHARS];
-      char last_str[MAX_METRIC_VALUE_CHARS];
-      format_fixed_point(current_value, decimals, current_str, sizeof(current_str));
-      format_fixed_point(last_history, decimals, last_str, sizeof(last_str));
-
-      if (strcmp(current_str, last_str) != 0) {
-        // Need to add current value to history
-        if (metric->history_count >= MAX_GRAPH_HISTORY_POINTS) {
-          // At capacity - shift left to make room
-          for (int i = 0; i < MAX_GRAPH_HISTORY_POINTS - 1; i++) {
-            metric->history[i] = metric->history[i + 1];
-          }
-          metric->history[MAX_GRAPH_HISTORY_POINTS - 1] = current_value;
-        } else {
-          // Just append
-          metric->history[metric->history_count] = current_value;
-          metric->history_count++;
-        }
+  invalidate_graph_geometry(buf_slot);
+  buf_slot->state = SLOT_READY;
+  buf_slot->stale = false;
+  return true;
+}
+
+// AppMessage Handling
+static void inbox_keys_init(void) {
+  // Metric arrays first: batched payloads are mostly their tuples
+  static const uint8_t metric_fields[] = {
+    METRIC_FIELD_INDEX, METRIC_FIELD_NAME, METRIC_FIELD_VALUE,
+    METRIC_FIELD_HISTORY, METRIC_FIELD_HISTORY_DROP, METRIC_FIELD_LAST_STEP,
+  };
+  const uint32_t metric_keys[] = {
+    MESSAGE_KEY_METRIC_INDEX, MESSAGE_KEY_METRIC_NAME, MESSAGE_KEY_METRIC_VALUE,
+    MESSAGE_KEY_METRIC_HISTORY, MESSAGE_KEY_METRIC_HISTORY_DROP, MESSAGE_KEY_METRIC_LAST_STEP,
+  };
+  const uint32_t field_keys[INBOX_FIELD_COUNT] = {
+    [INBOX_TRACE_SUMMARY] = MESSAGE_KEY_TRACE_SUMMARY,
+    [INBOX_OVERVIEW_DATA] = MESSAGE_KEY_OVERVIEW_DATA,
+    [INBOX_OVERVIEW_COUNT] = MESSAGE_KEY_OVERVIEW_COUNT,
+    [INBOX_OVERVIEW_FIRST] = MESSAGE_KEY_OVERVIEW_FIRST,
+    [INBOX_RUNS_PATCH] = MESSAGE_KEY_RUNS_PATCH,
+    [INBOX_RUNS_COUNT] = MESSAGE_KEY_RUNS_COUNT,
+    [INBOX_RUNS_IS_PAGE] = MESSAGE_KEY_RUNS_IS_PAGE,
+    [INBOX_RUNS_HAS_MORE] = MESSAGE_KEY_RUNS_HAS_MORE,
+    [INBOX_RUN_INDEX] = MESSAGE_KEY_RUN_INDEX,
+    [INBOX_RUN_NAME] = MESSAGE_KEY_RUN_NAME,
+    [INBOX_RUN_PROJECT] = MESSAGE_KEY_RUN_PROJECT,
+    [INBOX_RUN_STATE] = MESSAGE_KEY_RUN_STATE,
+    [INBOX_RUN_OWNER] = MESSAGE_KEY_RUN_OWNER,
+    [INBOX_METRICS_COUNT] = MESSAGE_KEY_METRICS_COUNT,
+  };
+
+  InboxKeyRange *range = s_inbox_keys;
+  for (int i = 0; i < METRIC_FIELD_COUNT; i++) {
+    *range++ = (InboxKeyRange){ metric_keys[i], METRIC_BATCH_MAX, metric_fields[i], true };
+  }
+  for (int i = 0; i < INBOX_FIELD_COUNT; i++) {
+    *range++ = (InboxKeyRange){ field_keys[i], 1, i, false };
+  }
+}
+
+// File each tuple by role in a single pass over the dictionary
+static void inbox_read_message(DictionaryIterator *iter, InboxMessage *message) {
+  for (const Tuple *tuple = dict_read_first(iter); tuple; tuple = dict_read_next(iter)) {
+    for (int i = 0; i < INBOX_KEY_RANGES; i++) {
+      const InboxKeyRange *range = &s_inbox_keys[i];
+      uint32_t offset = tuple->key - range->first_key;
+      if (offset >= range->count) continue;
+
+      if (range->metric_array) {
+        message->metrics[offset][range->field] = tuple;
+        if (range->field == METRIC_FIELD_INDEX) message->metric_entries |= 1 << offset;
+      } else {
+        message->fields[range->field] = tuple;
       }
+      break;
     }
+  }
+}
+
+static bool inbox_handle_trace(const InboxMessage *message) {
+  copy_tuple_string(s_diag_window.phone_trace, DIAG_TRACE_CHARS, message->fields[INBOX_TRACE_SUMMARY]);
+  if (s_diag_window.window) diag_window_render();
+  return true;
+}
+
+static bool inbox_handle_overview(const InboxMessage *message) {
+  store_overview_tiles(message);
+  return true;
+}
+
+static bool inbox_handle_runs_patch(const InboxMessage *message) {
+  apply_run_patch(message);
+  return true;
+}
 
-    buf_slot->state = SLOT_READY;
+// RUNS_COUNT heads a list or a page; an empty one completes here
+static bool inbox_handle_runs_count(const InboxMessage *message) {
+  s_expected_runs_count = message->fields[INBOX_RUNS_COUNT]->value->uint8;
+  if (s_expected_runs_count > MAX_WANDB_RUNS) s_expected_runs_count = MAX_WANDB_RUNS;
+  s_received_runs_count = 0;
 
-    // Refresh display (will show this metric if it's the current page)
+  // A page extends the window; otherwise this is a fresh list from the top
+  s_runs_paging = message->fields[INBOX_RUNS_IS_PAGE] != NULL;
+  const Tuple *has_more_tuple = message->fields[INBOX_RUNS_HAS_MORE];
+  if (has_more_tuple) s_runs_has_more = has_more_tuple->value->uint8;
+
+  if (s_runs_paging) {
+    if (s_expected_runs_count == 0) {
+      on_runs_page_complete();
+      return true;
+    }
+  } else {
+    s_runs_page_pending = false;
+
+    // Remember which run the metric buffer belongs to; rows are overwritten in place
+    if (s_buffered_run_index >= 0) snapshot_buffered_run();
+
+    // Handle 0 runs case immediately
+    if (s_expected_runs_count == 0) {
+      on_runs_list_complete();
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool inbox_handle_run_row(const InboxMessage *message) {
+  const Tuple *name_tuple = message->fields[INBOX_RUN_NAME];
+  const Tuple *project_tuple = message->fields[INBOX_RUN_PROJECT];
+  const Tuple *state_tuple = message->fields[INBOX_RUN_STATE];
+  if (!project_tuple || !state_tuple || s_received_runs_count >= s_expected_runs_count) return false;
+
+  if (!s_diag.first_row_ms) s_diag.first_row_ms = now_ms() - s_diag.started_ms;
+  const Tuple *index_tuple = message->fields[INBOX_RUN_INDEX];
+  const Tuple *owner_tuple = message->fields[INBOX_RUN_OWNER];
+  const char *project_name = owner_tuple ? owner_tuple->value->cstring : NULL;
+  WandbRun run = {
+    .list_index = index_tuple ? index_tuple->value->uint16 : s_received_runs_count,
+    .state = parse_run_state(state_tuple->value->cstring),
+  };
+
+  if (s_runs_paging) {
+    merge_run_row(&run, name_tuple->value->cstring, project_tuple->value->uint8, project_name);
+    s_received_runs_count++;
+  } else if (store_list_row(&run, name_tuple->value->cstring, project_tuple->value->uint8, project_name)) {
+    s_received_runs_count++;
+  } else {
+    // Out of string space: end the list here and page the rest in as the menu nears it
+    s_expected_runs_count = s_received_runs_count;
+    s_runs_has_more = true;
+  }
+  rebuild_run_sections();
+
+  // Check if all runs received
+  if (s_received_runs_count < s_expected_runs_count) {
+    if (!s_main.loading) reload_runs_menu();
+  } else if (s_runs_paging) {
+    on_runs_page_complete();
+  } else {
+    on_runs_list_complete();
+  }
+  return false;
+}
+
+// METRICS_COUNT is sent once with every metric batch, with the RUN_INDEX it belongs to. A batch
+// for another run (a push or a queued reply that arrives after switching runs) is dropped whole,
+// so it can't fill this run's slots or resize it.
+static bool inbox_handle_metrics_count(const InboxMessage *message) {
+  const Tuple *run_tuple = message->fields[INBOX_RUN_INDEX];
+  if (s_buffered_run_index < 0 || !run_tuple ||
+      run_tuple->value->uint16 != s_data.runs[s_buffered_run_index].list_index) {
+    return true;
+  }
+
+  WandbRun *run = &s_data.runs[s_buffered_run_index];
+  run->total_metrics = message->fields[INBOX_METRICS_COUNT]->value->uint8;
+
+  // Initial request may have speculatively claimed indices past the end of a short run
+  for (int i = 0; i < s_metric_buffer.num_slots; i++) {
+    if (s_metric_buffer.slots[i].metric_id >= run->total_metrics) {
+      s_metric_buffer.slots[i].metric_id = -1;
+      s_metric_buffer.slots[i].state = SLOT_EMPTY;
+    }
+  }
+  return false;
+}
+
+// Handlers run in order for each field the message carries, until one consumes the message
+static const struct {
+  InboxField field;
+  bool (*handle)(const InboxMessage *message);
+} s_inbox_handlers[] = {
+  { INBOX_TRACE_SUMMARY, inbox_handle_trace },
+  { INBOX_OVERVIEW_DATA, inbox_handle_overview },
+  { INBOX_RUNS_PATCH, inbox_handle_runs_patch },
+  { INBOX_RUNS_COUNT, inbox_handle_runs_count },
+  { INBOX_RUN_NAME, inbox_handle_run_row },
+  { INBOX_METRICS_COUNT, inbox_handle_metrics_count },
+};
+
+static void inbox_received_callback(DictionaryIterator *iter, void *context) {
+  s_diag.bytes_received += dict_size(iter);
+  diag_sample_heap();
+
+  InboxMessage message = {0};
+  inbox_read_message(iter, &message);
+
+  for (size_t i = 0; i < ARRAY_LENGTH(s_inbox_handlers); i++) {
+    if (!message.fields[s_inbox_handlers[i].field]) continue;
+    if (s_inbox_handlers[i].handle(&message)) return;
+  }
+
+  // Metric entries are packed into METRIC_*[N] keys, any number of them per message
+  bool received_metric = false;
+  for (uint8_t entry = 0; entry < METRIC_BATCH_MAX; entry++) {
+    if (!(message.metric_entries & (1 << entry))) continue;
+    received_metric |= store_metric_entry(message.metrics[entry]);
+  }
+
+  // Refresh display (will show the current page if it was part of the batch)
+  if (received_metric) {
     on_current_metric_ready();
   }
 }
 
 static void inbox_dropped_callback(AppMessageResult reason, void *context) {
   APP_LOG(APP_LOG_LEVEL_ERROR, "Message dropped: %d", reason);
+  s_diag.inbox_drops++;
 }
 
 // App Lifecycle
 static void prv_init(void) {
-  // Load saved refresh interval
-  if (persist_exists(PERSIST_KEY_REFRESH_INTERVAL)) {
-    s_refresh_interval_ms = persist_read_int(PERSIST_KEY_REFRESH_INTERVAL);
-  }
+  s_diag.started_ms = now_ms();
+
+  // Restore last session's runs (and metrics); the phone revalidates them in the background
+  s_ui.scroll_delta = 1;
+  metric_buffer_create();
+  metric_buffer_init();
+  bool warm_start = warm_cache_load();
 
   // Initialize AppMessage
+  inbox_keys_init();
   app_message_register_inbox_received(inbox_received_callback);
   app_message_register_inbox_dropped(inbox_dropped_callback);
-  app_message_open(512, 64);
+  app_message_register_outbox_sent(outbox_sent_callback);
+  app_message_register_outbox_failed(outbox_failed_callback);
+  s_inbox_size = app_message_inbox_size_maximum();
+  if (s_inbox_size > APP_MESSAGE_INBOX_CAP) s_inbox_size = APP_MESSAGE_INBOX_CAP;
+  app_message_open(s_inbox_size, APP_MESSAGE_OUTBOX_SIZE);
+
+  // Pause live updates while the phone is away or the battery is low
+  s_phone_connected = connection_service_peek_pebblekit_connection();
+  connection_service_subscribe((ConnectionHandlers) {
+    .pebblekit_connection_handler = app_connection_handler,
+  });
+  battery_state_handler(battery_state_service_peek());
+  battery_state_service_subscribe(battery_state_handler);
 
-  s_main.loading = true;
+  s_main.loading = !warm_start;
   s_main.window = window_create();
   window_set_window_handlers(s_main.window, (WindowHandlers) {
     .load = main_window_load,
@@ -1541,11 +3553,17 @@ static void prv_init(void) {
   window_stack_push(s_main.window, true);
 
   // Schedule loading timeout (8 seconds)
-  s_main.loading_timer = app_timer_register(8000, main_loading_timer_callback, NULL);
+  if (s_main.loading) {
+    s_main.loading_timer = app_timer_register(8000, main_loading_timer_callback, NULL);
+  }
 }
 
 static void prv_deinit(void) {
+  connection_service_unsubscribe();
+  battery_state_service_unsubscribe();
+  warm_cache_save();
   window_destroy(s_main.window);
+  metric_buffer_destroy();
 }
 
 int main(void) {
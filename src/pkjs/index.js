@@ -1,20 +1,145 @@
 var Clay = require('pebble-clay');
 var clayConfig = require('./config.json');
 var clay = new Clay(clayConfig);
+var keys = require('message_keys');
+
+// Must match METRIC_BATCH_MAX in wandb-for-pebble.c and the METRIC_*[N] keys in package.json
+var METRIC_BATCH_MAX = 8;
+
+// Inbox size assumed when the watch doesn't report one (matches older watch builds)
+var DEFAULT_INBOX_SIZE = 512;
+
+// METRIC_HISTORY wire formats (first payload byte), matching HISTORY_FORMAT_* on the watch
+var HISTORY_FORMAT_INT64 = 0;
+var HISTORY_FORMAT_Q8 = 1;
+var HISTORY_FORMAT_Q16 = 2;
+var HISTORY_FORMAT_VARINT = 3;
+
+// METRIC_VALUE decimals byte for a metric without a value (shown as ---), matching the watch
+var METRIC_VALUE_NONE = 0xFF;
+
+// History points the watch's graph can show; older watch builds don't report it
+var DEFAULT_HISTORY_POINTS = 20;
+// Samples fetched per displayed point before downsampling, and the most ever requested
+var HISTORY_OVERSAMPLE = 8;
+var MAX_HISTORY_SAMPLES = 500;
+// Share of the points a full downsample leaves free, so later samples can be appended to what
+// the watch holds (a history delta) until the run has grown by about a third
+var HISTORY_APPEND_HEADROOM = 0.25;
+
+// Metrics per RunMetrics query: one sampledHistory spec each, one summaryMetrics download
+var METRIC_FETCH_WINDOW = 8;
+
+// Overview tiles: sparkline points (4 bits each) and name bytes, matching the watch's OverviewTile
+var OVERVIEW_SPARK_POINTS = 16;
+var OVERVIEW_SPARK_LEVELS = 15;
+var OVERVIEW_NAME_BYTES = 19;
+var OVERVIEW_VALUE_BYTES = 15;
+
+// Runs list fetching: projects per aliased GraphQL document, documents in flight at once
+var PROJECTS_PER_QUERY = 20;
+var MAX_CONCURRENT_QUERIES = 2;
+var RUNS_PER_PROJECT = 5;
+
+// Rows sent to the watch when the app opens, then per page as its menu nears either end
+var RUNS_FIRST_PAGE_SIZE = 10;
+var RUNS_PAGE_SIZE = 5;
+
+// The runs list is re-fetched this often while the app is open (or every two refresh
+// intervals, if longer), and only changed rows are sent to the watch
+var RUNS_REFRESH_MIN_MS = 60 * 1000;
+
+// How long the viewer entity and project list are reused before being fetched again
+var PROJECTS_CACHE_TTL_MS = 10 * 60 * 1000;
+
+// Warm start: the runs list is sent from localStorage on `ready` and revalidated in the
+// background, unless it is older than this. Metric names are stored for the most recent runs,
+// and those of unfinished runs are reused only while fresh, since the watch addresses by index.
+var RUNS_STORE_MAX_AGE_MS = 7 * 24 * 60 * 60 * 1000;
+var METRIC_NAMES_STORE_MAX_RUNS = 20;
+var METRIC_NAMES_STORE_TTL_MS = 10 * 60 * 1000;
+
+// Runs whose sorted metric names are kept in memory, least recently used dropped first
+var METRIC_NAMES_CACHE_MAX_RUNS = 16;
+
+// Metric values of runs in these states never change, so their cache entries never expire
+var TERMINAL_RUN_STATES = ['finished', 'crashed', 'failed', 'killed'];
+var METRIC_CACHE_MAX_ENTRIES = 200;
+
+// Poll interval for subscribed metrics when the refreshInterval setting is missing (Clay default)
+var DEFAULT_REFRESH_INTERVAL_MS = 30000;
+// Unchanged polls double the interval up to this cap; any change snaps back to refreshInterval
+var POLL_BACKOFF_MAX_MS = 10 * 60 * 1000;
+
+// Outbound AppMessage retries
+var SEND_MAX_ATTEMPTS = 4;
+var SEND_RETRY_BASE_MS = 250;
+
+// Request tracing: latency histogram bucket upper bounds (the last bucket is open-ended)
+// and how many recent requests are kept
+var TRACE_BUCKETS_MS = [100, 250, 500, 1000, 2000, 5000, 10000];
+var TRACE_RECENT_MAX = 32;
+var TRACE_SUMMARY_MAX_CHARS = 255;  // Must fit the watch's DIAG_TRACE_CHARS buffer
+
+// Headlines: the top metric of the most recent running runs, published as the app glance
+// (first run) and, when enabled, one timeline pin per run
+var HEADLINE_MAX_RUNS = 3;
+var HEADLINE_MIN_CHANGE = 0.01;               // Relative change worth republishing
+var HEADLINE_FIRST_DELAY_MS = 10000;          // Stay out of the way of the cold-start fetches
+var HEADLINE_REFRESH_MS = 5 * 60 * 1000;
+var HEADLINE_HISTORY_POINTS = 2;              // Only the value is used
+var HEADLINE_GLANCE_TTL_MS = 6 * 60 * 60 * 1000;  // A running run's value is old news after this
+var TIMELINE_PIN_URL = 'https://timeline-api.rebble.io/v1/user/pins/';
 
 // Load settings from localStorage
 var settings = localStorage.getItem('clay-settings');
 var config = settings ? JSON.parse(settings) : {};
 
 // Module-level state
-var runs = [];
+var runs = [];          // Full runs list; the watch addresses rows by their index here. Patches
+                        // keep indices (new runs appended, removed ones kept as 'removed');
+                        // a reorder replaces the list and resends it from the top
+var runsRefreshTimer = null;
+var runCursors = [];    // Per project: { entity, name, cursor, hasNextPage } for the next runs page
+var projectIds = {};    // 'entity/project' -> small ID the watch interns the project string under
+var nextProjectId = 0;
 var client = new WandbClient(config.apiKey, config.baseUrl);
 
-// Cache for sorted metric names (NOT values - those are fetched fresh)
-var cachedMetricNames = {
-  runKey: null,           // "entity/project/runName"
-  names: []               // Array of metric names in sorted order
-};
+// Stored sorted metric names by runKey: { names, savedAt }
+var storedMetricNames = loadStored('metricNames') || {};
+client.projectsCache = loadStored('projects');
+
+// Sorted metric names (NOT values - those are fetched fresh) of recently used runs, keyed by
+// "entity/project/runName": { names, usedAt }
+var cachedMetricNames = {};
+
+// _step of every history point last sent to the watch, keyed by "entity/project/runName/metric"
+var sentHistorySteps = {};
+
+// Fetched metric values, same keys: { metric, fetchedAt }. Served immediately, refreshed when stale.
+var metricCache = {};
+
+// Hash of the value and history last sent to the watch, keyed like sentHistorySteps
+var sentPayloadHashes = {};
+
+// Request stats by operation: the GraphQL operation name, or 'AppMessage' for the hop to the
+// watch. { count, errors, retries, shared, bytes, totalMs, firstByteMs, firstByteCount, histogram },
+// where `shared` counts calls that joined an identical request already in flight.
+// `traceRecent` keeps the last TRACE_RECENT_MAX requests: { op, ms, firstByteMs, bytes, attempts, error }
+var traceStats = {};
+var traceRecent = [];
+
+// Headline metric name per runKey, and the value last published for it: { fixed, decimals }.
+// The app glance shows the headline of glanceRunKey.
+var headlineNames = {};
+var publishedHeadlines = JSON.parse(localStorage.getItem('headlines') || '{}');
+var glanceRunKey = localStorage.getItem('glanceRunKey');
+var headlineTimer = null;
+
+// Metrics the watch wants pushed when they change:
+// { runKey, runInfo, firstIndex, count, inboxSize, historyPoints, unchangedPolls }
+var subscription = null;
+var subscriptionTimer = null;
 
 function base64Encode(str) {
   var chars = 'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=';
@@ -39,15 +164,182 @@ function base64Encode(str) {
   return output;
 }
 
+// localStorage entries are tagged with the account they were fetched for and ignored after
+// the API key or server changes
+function accountKey() {
+  return String(djb2((config.apiKey || '') + '|' + (config.baseUrl || '')));
+}
+
+function loadStored(name) {
+  var entry = null;
+  try {
+    entry = JSON.parse(localStorage.getItem('warm:' + name));
+  } catch (e) {
+    console.log('Discarding stored ' + name + ': ' + e);
+  }
+  return entry && entry.account === accountKey() ? entry.value : null;
+}
+
+function saveStored(name, value) {
+  try {
+    localStorage.setItem('warm:' + name, JSON.stringify({ account: accountKey(), value: value }));
+  } catch (e) {
+    console.log('Could not store ' + name + ': ' + e);
+  }
+}
+
 function WandbClient(apiKey, baseUrl) {
   this.apiKey = apiKey;
   this.endpoint = baseUrl || 'https://api.wandb.ai/graphql';
+  this.projectsCache = null;  // { entity, projects: [...], fetchedAt: ms }, kept in localStorage
+  this.inFlight = {};         // Query + variables -> callbacks waiting on the one XHR for it
+}
+
+// Request tracing
+function operationName(query) {
+  var match = /^\s*query\s+(\w+)/.exec(query);
+  return match ? match[1] : 'Anonymous';
+}
+
+function traceBucket(ms) {
+  for (var i = 0; i < TRACE_BUCKETS_MS.length; i++) {
+    if (ms <= TRACE_BUCKETS_MS[i]) return i;
+  }
+  return TRACE_BUCKETS_MS.length;
+}
+
+function traceStatsFor(op) {
+  if (!traceStats[op]) {
+    traceStats[op] = {
+      count: 0, errors: 0, retries: 0, shared: 0, bytes: 0, totalMs: 0, firstByteMs: 0, firstByteCount: 0,
+      histogram: TRACE_BUCKETS_MS.map(function () { return 0; }).concat([0])
+    };
+  }
+  return traceStats[op];
+}
+
+function traceRecord(span) {
+  var stats = traceStatsFor(span.op);
+
+  stats.count++;
+  stats.errors += span.error ? 1 : 0;
+  stats.retries += span.attempts - 1;
+  stats.bytes += span.bytes;
+  stats.totalMs += span.ms;
+  stats.histogram[traceBucket(span.ms)]++;
+  if (span.firstByteMs !== null) {
+    stats.firstByteMs += span.firstByteMs;
+    stats.firstByteCount++;
+  }
+
+  traceRecent.push(span);
+  if (traceRecent.length > TRACE_RECENT_MAX) traceRecent.shift();
+}
+
+// Upper bound of the histogram bucket holding the `fraction` quantile ('>max' past the last)
+function tracePercentile(stats, fraction) {
+  var target = Math.ceil(stats.count * fraction);
+  var seen = 0;
+  for (var i = 0; i < stats.histogram.length; i++) {
+    seen += stats.histogram[i];
+    if (seen >= target) {
+      return i < TRACE_BUCKETS_MS.length ? String(TRACE_BUCKETS_MS[i]) : '>' + TRACE_BUCKETS_MS[i - 1];
+    }
+  }
+  return '-';
+}
+
+// Compact per-operation summary for the watch's diagnostics page, slowest operations first.
+// "p50/p90" are histogram bucket bounds; "ttfb" is the mean wait for W&B's response headers.
+function traceSummary(maxChars) {
+  var ops = Object.keys(traceStats).sort(function (a, b) {
+    return traceStats[b].totalMs - traceStats[a].totalMs;
+  });
+  var text = '';
+  for (var i = 0; i < ops.length; i++) {
+    var stats = traceStats[ops[i]];
+    var line = ops[i] + ' x' + stats.count + ' p50 ' + tracePercentile(stats, 0.5) +
+      ' p90 ' + tracePercentile(stats, 0.9) + 'ms\n' +
+      (stats.firstByteCount ? ' ttfb ' + Math.round(stats.firstByteMs / stats.firstByteCount) + 'ms' : '') +
+      ' ' + Math.round(stats.bytes / 1024) + 'KB ' + stats.retries + 'rt ' + stats.errors + 'err' +
+      (stats.shared ? ' ' + stats.shared + 'sh' : '') + '\n';
+    if (text.length + line.length > maxChars) break;
+    text += line;
+  }
+  return text || 'No requests yet';
 }
 
-WandbClient.prototype.request = function (query, variables, callback, retryCount) {
+// Run async tasks (each taking a `done` callback) with at most `limit` in flight
+function runWithConcurrency(tasks, limit, callback) {
+  var next = 0;
+  var active = 0;
+  var finished = 0;
+
+  if (tasks.length === 0) return callback();
+
+  function launch() {
+    while (active < limit && next < tasks.length) {
+      active++;
+      tasks[next++](function () {
+        active--;
+        finished++;
+        if (finished === tasks.length) return callback();
+        launch();
+      });
+    }
+  }
+
+  launch();
+}
+
+// Identical concurrent requests (same query and variables) share one XHR; every caller gets
+// the same response object, so callbacks must not modify it
+WandbClient.prototype.request = function (query, variables, callback) {
+  var self = this;
+  var key = query + '\n' + JSON.stringify(variables || null);
+  var waiting = this.inFlight[key];
+
+  if (waiting) {
+    traceStatsFor(operationName(query)).shared++;
+    waiting.push(callback);
+    return;
+  }
+
+  waiting = this.inFlight[key] = [callback];
+  this.sendRequest(query, variables, function (err, data) {
+    delete self.inFlight[key];
+    waiting.forEach(function (waiter) {
+      waiter(err, data);
+    });
+  });
+};
+
+// `trace` follows one logical request across its retries
+WandbClient.prototype.sendRequest = function (query, variables, callback, retryCount, trace) {
   var self = this;
   var maxRetries = 3;
   var currentRetry = retryCount || 0;
+  var attemptStartedAt = Date.now();
+  var firstByteMs = null;
+  trace = trace || { op: operationName(query), startedAt: attemptStartedAt, bytes: 0 };
+
+  function retry() {
+    setTimeout(function() {
+      self.sendRequest(query, variables, callback, currentRetry + 1, trace);
+    }, 1000 * (currentRetry + 1)); // Exponential backoff
+  }
+
+  function finish(err, data) {
+    traceRecord({
+      op: trace.op,
+      ms: Date.now() - trace.startedAt,
+      firstByteMs: firstByteMs,
+      bytes: trace.bytes,
+      attempts: currentRetry + 1,
+      error: err ? String(err).slice(0, 80) : null
+    });
+    callback(err, data);
+  }
 
   var xhr = new XMLHttpRequest();
   xhr.open('POST', this.endpoint, true);
@@ -55,46 +347,40 @@ WandbClient.prototype.request = function (query, variables, callback, retryCount
   xhr.setRequestHeader('Authorization', 'Basic ' + base64Encode('api:' + this.apiKey));
 
   xhr.onreadystatechange = function () {
+    // Headers in: W&B has answered; the rest of the time is the download over the phone's radio
+    if (xhr.readyState === 2) firstByteMs = Date.now() - attemptStartedAt;
     if (xhr.readyState !== 4) return;
+    trace.bytes += xhr.responseText ? xhr.responseText.length : 0;
 
     if (xhr.status !== 200) {
       // Retry on server errors (5xx) or timeout
       if ((xhr.status >= 500 || xhr.status === 0) && currentRetry < maxRetries) {
         console.log('Request failed with HTTP ' + xhr.status + ', retrying (' + (currentRetry + 1) + '/' + maxRetries + ')');
-        setTimeout(function() {
-          self.request(query, variables, callback, currentRetry + 1);
-        }, 1000 * (currentRetry + 1)); // Exponential backoff
-        return;
+        return retry();
       }
-      return callback('HTTP ' + xhr.status, null);
+      return finish('HTTP ' + xhr.status, null);
     }
 
     try {
       var response = JSON.parse(xhr.responseText);
-      if (response.errors) return callback(response.errors, null);
-      callback(null, response.data);
+      if (response.errors) return finish(response.errors, null);
+      finish(null, response.data);
     } catch (e) {
       console.log('JSON parse error: ' + e.message);
       if (currentRetry < maxRetries) {
         console.log('Retrying after parse error (' + (currentRetry + 1) + '/' + maxRetries + ')');
-        setTimeout(function() {
-          self.request(query, variables, callback, currentRetry + 1);
-        }, 1000 * (currentRetry + 1));
-        return;
+        return retry();
       }
-      callback('JSON parse error: ' + e.message, null);
+      finish('JSON parse error: ' + e.message, null);
     }
   };
 
   xhr.onerror = function () {
     if (currentRetry < maxRetries) {
       console.log('Network error, retrying (' + (currentRetry + 1) + '/' + maxRetries + ')');
-      setTimeout(function() {
-        self.request(query, variables, callback, currentRetry + 1);
-      }, 1000 * (currentRetry + 1));
-      return;
+      return retry();
     }
-    callback('Network error', null);
+    finish('Network error', null);
   };
 
   var body = { query: query };
@@ -104,33 +390,50 @@ WandbClient.prototype.request = function (query, variables, callback, retryCount
     xhr.send(JSON.stringify(body));
   } catch (e) {
     console.log('Send error: ' + e.message);
-    if (currentRetry < maxRetries) {
-      setTimeout(function() {
-        self.request(query, variables, callback, currentRetry + 1);
-      }, 1000 * (currentRetry + 1));
-      return;
-    }
-    callback('Send error: ' + e.message, null);
+    if (currentRetry < maxRetries) return retry();
+    finish('Send error: ' + e.message, null);
   }
 };
 
 WandbClient.prototype.fetchViewer = function (callback) {
-  var query = 'query { viewer { entity username } }';
+  var query = 'query Viewer { viewer { entity username } }';
   this.request(query, null, callback);
 };
 
 WandbClient.prototype.fetchProjects = function (entity, callback) {
-  var query = 'query($entity: String!) { models(entityName: $entity, first: 100) { edges { node { name entityName } } } }';
+  var query = 'query Projects($entity: String!) { models(entityName: $entity, first: 100) { edges { node { name entityName } } } }';
   this.request(query, { entity: entity }, callback);
 };
 
-WandbClient.prototype.fetchRuns = function (entity, project, callback) {
-  var query = 'query($entity: String!, $project: String!) { project(name: $project, entityName: $entity) { runs(first: 5, order: "-createdAt") { edges { node { name displayName state createdAt } } } } }';
-  this.request(query, { entity: entity, project: project }, callback);
+// Fetch the next page of runs of several projects in one document, aliasing each project as pN.
+// `project.cursor` is the endCursor of the page before (null for the first page).
+WandbClient.prototype.fetchRunsForProjects = function (projects, callback) {
+  var params = [];
+  var fields = [];
+  var variables = {};
+
+  projects.forEach(function (project, i) {
+    params.push('$e' + i + ': String!, $n' + i + ': String!, $a' + i + ': String');
+    fields.push('p' + i + ': project(name: $n' + i + ', entityName: $e' + i + ') { ' +
+      'runs(first: ' + RUNS_PER_PROJECT + ', after: $a' + i + ', order: "-createdAt") { ' +
+        'edges { node { name displayName state createdAt } } pageInfo { endCursor hasNextPage } } }');
+    variables['e' + i] = project.entity;
+    variables['n' + i] = project.name;
+    variables['a' + i] = project.cursor || null;
+  });
+
+  var query = 'query Runs(' + params.join(', ') + ') { ' + fields.join(' ') + ' }';
+  this.request(query, variables, callback);
 };
 
-WandbClient.prototype.fetchAllRuns = function (callback) {
+// Viewer entity and project list, reused for PROJECTS_CACHE_TTL_MS
+WandbClient.prototype.fetchAllProjects = function (callback) {
   var self = this;
+  var cache = this.projectsCache;
+
+  if (cache && Date.now() - cache.fetchedAt < PROJECTS_CACHE_TTL_MS) {
+    return callback(null, cache.projects);
+  }
 
   this.fetchViewer(function (err, data) {
     if (err) return callback(err, null);
@@ -147,30 +450,76 @@ WandbClient.prototype.fetchAllRuns = function (callback) {
         });
       }
 
-      if (allProjects.length === 0) return callback(null, []);
-
-      var allRuns = [];
-      var pendingProjects = allProjects.length;
+      self.projectsCache = { entity: entity, projects: allProjects, fetchedAt: Date.now() };
+      saveStored('projects', self.projectsCache);
+      callback(null, allProjects);
+    });
+  });
+};
 
-      allProjects.forEach(function (project) {
-        self.fetchRuns(project.entity, project.name, function (err, data) {
-          if (!err && data.project && data.project.runs) {
-            data.project.runs.edges.forEach(function (edge) {
-              allRuns.push({ entity: project.entity, project: project.name, run: edge.node });
-            });
-          }
+// Fetch the next runs page of each of `cursors` ({ entity, name, cursor }).
+// Calls back with the runs in project order and each project's cursor for the page after.
+WandbClient.prototype.fetchRunsPage = function (cursors, callback) {
+  var self = this;
 
-          pendingProjects--;
-          if (pendingProjects === 0) callback(null, allRuns);
+  // Split projects into aliased documents; results are merged back in project order
+  var chunks = [];
+  for (var i = 0; i < cursors.length; i += PROJECTS_PER_QUERY) {
+    chunks.push(cursors.slice(i, i + PROJECTS_PER_QUERY));
+  }
+  var chunkRuns = [];
+  var nextCursors = [];
+
+  var tasks = chunks.map(function (chunk, chunkIndex) {
+    return function (done) {
+      self.fetchRunsForProjects(chunk, function (err, data) {
+        var found = [];
+        chunk.forEach(function (project, j) {
+          var node = !err && data['p' + j];
+          var pageInfo = node && node.runs ? node.runs.pageInfo : null;
+          // A failed chunk keeps its cursors, so the same page is tried again next time
+          nextCursors[chunkIndex * PROJECTS_PER_QUERY + j] = {
+            entity: project.entity,
+            name: project.name,
+            cursor: pageInfo ? pageInfo.endCursor : project.cursor,
+            hasNextPage: err ? true : !!(pageInfo && pageInfo.hasNextPage)
+          };
+          if (!node || !node.runs) return;
+          node.runs.edges.forEach(function (edge) {
+            found.push({ entity: project.entity, project: project.name, run: edge.node });
+          });
         });
+        if (err) {
+          console.log('Error fetching runs for ' + chunk.length + ' projects: ' + JSON.stringify(err));
+        }
+        chunkRuns[chunkIndex] = found;
+        done();
       });
+    };
+  });
+
+  runWithConcurrency(tasks, MAX_CONCURRENT_QUERIES, function () {
+    callback(null, { runs: [].concat.apply([], chunkRuns), cursors: nextCursors });
+  });
+};
+
+// First runs page of every project
+WandbClient.prototype.fetchAllRuns = function (callback) {
+  var self = this;
+
+  this.fetchAllProjects(function (err, allProjects) {
+    if (err) return callback(err, null);
+
+    var cursors = allProjects.map(function (project) {
+      return { entity: project.entity, name: project.name, cursor: null };
     });
+    self.fetchRunsPage(cursors, callback);
   });
 };
 
 // Fetch only metric names (for sorting/caching) - lightweight call
 WandbClient.prototype.fetchMetricNames = function (entity, project, runName, callback) {
-  var query = 'query($entity: String!, $project: String!, $runName: String!) { ' +
+  var query = 'query MetricNames($entity: String!, $project: String!, $runName: String!) { ' +
     'project(name: $project, entityName: $entity) { ' +
       'run(name: $runName) { ' +
         'summaryMetrics historyKeys ' +
@@ -236,11 +585,57 @@ WandbClient.prototype.fetchMetricNames = function (entity, project, runName, cal
   });
 };
 
-// Fetch a single metric's current value and history
-WandbClient.prototype.fetchSingleMetric = function (entity, project, runName, metricName, callback) {
-  var specs = [JSON.stringify({ keys: ['_step', metricName], samples: 20 })];
+// Build a display metric from the run's parsed summary and its sampled history rows
+function buildMetric(metricName, summary, rows, points, sentSteps) {
+  var value = summary[metricName];
+
+  // Format value for display; the watch gets the same value as fixed point plus decimals
+  var displayValue;
+  var decimals = 0;
+  var fixed = null;
+  if (value === undefined || value === null) {
+    displayValue = '---';
+  } else {
+    if (Math.abs(value) >= 1000) {
+      decimals = 0;
+    } else if (Math.abs(value) >= 1) {
+      decimals = 2;
+    } else {
+      decimals = 4;
+    }
+    displayValue = value.toFixed(decimals);
+    fixed = toDisplayFixedPoint(value, decimals);
+  }
+
+  // Parse history
+  var values = [];
+  var sampleSteps = [];
 
-  var query = 'query($entity: String!, $project: String!, $runName: String!, $specs: [JSONString!]!) { ' +
+  for (var j = 0; j < rows.length; j++) {
+    var val = rows[j][metricName];
+    if (val !== undefined && val !== null) {
+      values.push(val);
+      sampleSteps.push(rows[j]._step);
+    }
+  }
+
+  var kept = keptHistoryIndices(sampleSteps, values, points, sentSteps);
+  var history = kept.map(function (k) { return toFixedPoint(values[k]); });
+  var steps = kept.map(function (k) { return sampleSteps[k]; });
+
+  return { name: metricName, value: displayValue, fixed: fixed, decimals: decimals, history: history, steps: steps };
+}
+
+// Fetch several metrics of one run, each downsampled to `points` samples, in one query:
+// summaryMetrics is downloaded and parsed once, with one sampledHistory spec per metric.
+// Calls back with the metrics in `metricNames` order.
+WandbClient.prototype.fetchRunMetrics = function (entity, project, runName, metricNames, points, callback) {
+  var samples = Math.min(points * HISTORY_OVERSAMPLE, MAX_HISTORY_SAMPLES);
+  var specs = metricNames.map(function (metricName) {
+    return JSON.stringify({ keys: ['_step', metricName], samples: samples });
+  });
+
+  var query = 'query RunMetrics($entity: String!, $project: String!, $runName: String!, $specs: [JSONString!]!) { ' +
     'project(name: $project, entityName: $entity) { ' +
       'run(name: $runName) { ' +
         'summaryMetrics sampledHistory(specs: $specs) ' +
@@ -254,33 +649,13 @@ WandbClient.prototype.fetchSingleMetric = function (entity, project, runName, me
     try {
       var run = data.project.run;
       var summary = JSON.parse(run.summaryMetrics);
-      var value = summary[metricName];
-
-      // Format value for display
-      var displayValue;
-      if (value === undefined || value === null) {
-        displayValue = '---';
-      } else if (Math.abs(value) >= 1000) {
-        displayValue = value.toFixed(0);
-      } else if (Math.abs(value) >= 1) {
-        displayValue = value.toFixed(2);
-      } else {
-        displayValue = value.toFixed(4);
-      }
+      var sampledHistory = run.sampledHistory || [];
 
-      // Parse history
-      var sampledHistory = run.sampledHistory;
-      var rows = sampledHistory[0] || [];
-      var history = [];
-
-      for (var j = 0; j < rows.length; j++) {
-        var val = rows[j][metricName];
-        if (val !== undefined && val !== null) {
-          history.push(toFixedPoint(val));
-        }
-      }
-
-      callback(null, { name: metricName, value: displayValue, history: history });
+      callback(null, metricNames.map(function (metricName, k) {
+        // What the watch holds of this metric, so its points can be kept and only the tail added
+        var sentSteps = sentHistorySteps[entity + '/' + project + '/' + runName + '/' + metricName];
+        return buildMetric(metricName, summary, sampledHistory[k] || [], points, sentSteps);
+      }));
     } catch (e) {
       console.log('Error processing metric data: ' + e.message);
       callback('Error processing metric data: ' + e.message, null);
@@ -288,53 +663,330 @@ WandbClient.prototype.fetchSingleMetric = function (entity, project, runName, me
   });
 };
 
-function sendRunsToWatch(runs) {
-  if (runs.length === 0) {
-    Pebble.sendAppMessage({ 'RUNS_COUNT': 0 }, function () {}, function (err) {
-      console.log('Failed to send empty count: ' + JSON.stringify(err));
+// Split `indices` into METRIC_FETCH_WINDOW-sized groups, one RunMetrics query each
+function metricFetchChunks(indices) {
+  var chunks = [];
+  for (var i = 0; i < indices.length; i += METRIC_FETCH_WINDOW) {
+    chunks.push(indices.slice(i, i + METRIC_FETCH_WINDOW));
+  }
+  return chunks;
+}
+
+// Running runs first, then by state, keeping the given order within a state; applied per
+// fetched page so earlier indices stay put
+function sortRuns(list) {
+  var positioned = list.map(function (item, i) { return { item: item, position: i }; });
+  positioned.sort(function (a, b) {
+    var aState = a.item.run.state;
+    var bState = b.item.run.state;
+    if (aState === 'running' && bState !== 'running') return -1;
+    if (aState !== 'running' && bState === 'running') return 1;
+    if (aState < bState) return -1;
+    if (aState > bState) return 1;
+    return a.position - b.position;
+  });
+  return positioned.map(function (entry) { return entry.item; });
+}
+
+function hasMoreRuns() {
+  return runCursors.some(function (cursor) { return cursor.hasNextPage; });
+}
+
+// Fetch further runs pages until `count` runs are known or the projects run out
+function ensureRunsLoaded(count, callback) {
+  if (runs.length >= count || !hasMoreRuns()) return callback();
+
+  var pending = runCursors.filter(function (cursor) { return cursor.hasNextPage; });
+  client.fetchRunsPage(pending, function (err, page) {
+    if (err) return callback();
+
+    // Replace the cursors that were advanced, keep exhausted ones
+    var byProject = {};
+    page.cursors.forEach(function (cursor) { byProject[cursor.entity + '/' + cursor.name] = cursor; });
+    runCursors = runCursors.map(function (cursor) {
+      return byProject[cursor.entity + '/' + cursor.name] || cursor;
     });
+
+    if (page.runs.length > 0) runs = runs.concat(sortRuns(page.runs));
+    saveRuns();
+    if (page.runs.length === 0) return callback();
+    ensureRunsLoaded(count, callback);
+  });
+}
+
+// Stable for the session; the watch rebinds cached projects to these IDs by name.
+// Wraps at 255 (RUN_PROJECT_NONE on the watch), which only costs a rebinding on the watch.
+function projectId(owner) {
+  if (!(owner in projectIds)) {
+    projectIds[owner] = nextProjectId;
+    nextProjectId = (nextProjectId + 1) % 255;
+  }
+  return projectIds[owner];
+}
+
+// Send rows [start, start + count) to the watch. A fresh list (not a page) starts at 0 and
+// supersedes anything queued; backward pages go out nearest-first so each row touches the window.
+// Each project's string goes with its first row in the batch; later rows carry only its ID.
+function sendRunsToWatch(start, count, isPage, backward) {
+  var end = Math.min(start + count, runs.length);
+  var indices = [];
+  for (var i = start; i < end; i++) indices.push(i);
+  if (backward) indices.reverse();
+
+  var header = { 'RUNS_COUNT': indices.length };
+  if (isPage) header['RUNS_IS_PAGE'] = 1;
+  if (!backward) header['RUNS_HAS_MORE'] = end < runs.length || hasMoreRuns() ? 1 : 0;
+
+  // A newer list supersedes rows of an older one still waiting to go out
+  if (!isPage) dropQueuedMessages('run:');
+
+  if (indices.length === 0) {
+    queueMessage({ key: 'run:' + start, message: header, label: 'empty runs count' });
     return;
   }
 
-  runs.sort(function (a, b) {
-    if (a.run.state === 'running' && b.run.state !== 'running') return -1;
-    if (a.run.state !== 'running' && b.run.state === 'running') return 1;
-    if (a.run.state < b.run.state) return -1;
-    if (a.run.state > b.run.state) return 1;
-    return 0;
+  var sentProjects = {};
+  indices.forEach(function (index, n) {
+    var owner = runs[index].entity + '/' + runs[index].project;
+    var message = runRowMessage(index, n === 0 ? header : {}, !sentProjects[owner]);
+    sentProjects[owner] = true;
+    queueMessage({ key: 'run:' + index, message: message, label: 'run ' + index });
   });
+}
 
-  var index = 0;
+// Add row `index`'s fields to `message`, with the project string when `withOwner`
+function runRowMessage(index, message, withOwner) {
+  var item = runs[index];
+  var owner = item.entity + '/' + item.project;
+  message['RUN_INDEX'] = index;
+  message['RUN_NAME'] = item.run.displayName || item.run.name;
+  message['RUN_PROJECT'] = projectId(owner);
+  message['RUN_STATE'] = item.run.state;
+  if (withOwner) message['RUN_OWNER'] = owner;
+  return message;
+}
 
-  function sendNext() {
-    if (index >= runs.length) return;
+function runKeyOf(runInfo) {
+  return runInfo.entity + '/' + runInfo.project + '/' + runInfo.run.name;
+}
 
-    var item = runs[index];
-    var message = {
-      'RUN_NAME': item.run.displayName || item.run.name,
-      'RUN_OWNER': item.entity + '/' + item.project,
-      'RUN_STATE': item.run.state
-    };
+// List index the watch knows the run by, or -1 if it's no longer in the list
+function runIndexOf(runKey) {
+  for (var i = 0; i < runs.length; i++) {
+    if (runKeyOf(runs[i]) === runKey) return i;
+  }
+  return -1;
+}
 
-    if (index === 0) {
-      message['RUNS_COUNT'] = runs.length;
+function saveRuns() {
+  saveStored('runs', { runs: runs, cursors: runCursors, savedAt: Date.now() });
+}
+
+// The stored runs list, without its removed rows: a fresh list renumbers them anyway
+function loadStoredRuns() {
+  var stored = loadStored('runs');
+  if (!stored || !stored.runs || Date.now() - stored.savedAt > RUNS_STORE_MAX_AGE_MS) return null;
+  stored.runs = stored.runs.filter(function (runInfo) { return runInfo.run.state !== 'removed'; });
+  return stored;
+}
+
+function scheduleRunsRefresh() {
+  if (runsRefreshTimer) clearTimeout(runsRefreshTimer);
+  runsRefreshTimer = setTimeout(refreshRunsList, Math.max(RUNS_REFRESH_MIN_MS, 2 * refreshIntervalMs()));
+}
+
+// Re-fetch the first runs page of every project and diff it against the list the watch
+// addresses. Known runs are updated in place, new ones appended, and runs missing from a
+// project whose whole list was fetched marked 'removed'. Only those rows go to the watch.
+function refreshRunsList() {
+  scheduleRunsRefresh();
+
+  client.fetchAllRuns(function (err, page) {
+    if (err) {
+      console.log('Error refreshing runs: ' + JSON.stringify(err));
+      return;
+    }
+
+    var indexByKey = {};
+    runs.forEach(function (runInfo, i) { indexByKey[runKeyOf(runInfo)] = i; });
+
+    var patched = [];
+    var added = [];
+    var fetched = {};
+    page.runs.forEach(function (fresh) {
+      var key = runKeyOf(fresh);
+      fetched[key] = true;
+      if (!(key in indexByKey)) return added.push(fresh);
+
+      var known = runs[indexByKey[key]].run;
+      if (known.state !== fresh.run.state || known.displayName !== fresh.run.displayName) {
+        known.state = fresh.run.state;
+        known.displayName = fresh.run.displayName;
+        patched.push(indexByKey[key]);
+      }
+    });
+
+    // Projects whose first page was their whole list; new projects page on from here
+    var complete = {};
+    var knownCursors = {};
+    runCursors.forEach(function (cursor) { knownCursors[cursor.entity + '/' + cursor.name] = true; });
+    page.cursors.forEach(function (cursor) {
+      var owner = cursor.entity + '/' + cursor.name;
+      if (!cursor.hasNextPage) complete[owner] = true;
+      if (!knownCursors[owner]) runCursors.push(cursor);
+    });
+
+    runs.forEach(function (runInfo, i) {
+      if (runInfo.run.state === 'removed' || fetched[runKeyOf(runInfo)]) return;
+      if (!complete[runInfo.entity + '/' + runInfo.project]) return;
+      runInfo.run.state = 'removed';
+      patched.push(i);
+    });
+
+    sortRuns(added).forEach(function (runInfo) {
+      patched.push(runs.length);
+      runs.push(runInfo);
+    });
+
+    // New runs and state changes can move rows (a list from the last session only ever gets
+    // patched otherwise): then the watch gets a fresh first page instead of patches past its window
+    var live = runs.filter(function (runInfo) { return runInfo.run.state !== 'removed'; });
+    var sorted = sortRuns(live);
+    var moved = sorted.some(function (runInfo, i) { return runInfo !== live[i]; });
+    if (moved) {
+      console.log('Runs list reordered: ' + added.length + ' new, sending a fresh list');
+      runs = sorted;
+      saveRuns();
+      dropQueuedMessages('runpatch:');
+      sendRunsToWatch(0, RUNS_FIRST_PAGE_SIZE, false, false);
+      return;
     }
+    saveRuns();
 
-    Pebble.sendAppMessage(message, function () {
-      index++;
-      sendNext();
-    }, function (err) {
-      console.log('Failed to send run: ' + JSON.stringify(err));
+    if (patched.length === 0) return;
+    console.log('Runs list changed: ' + patched.length + ' rows, ' + added.length + ' new');
+    patched.forEach(function (index) {
+      var message = runRowMessage(index, { 'RUNS_PATCH': 1 }, true);
+      queueMessage({ key: 'runpatch:' + index, message: message, label: 'run patch ' + index });
     });
+  });
+}
+
+// Largest-Triangle-Three-Buckets: indices of the `threshold` samples that best keep the
+// curve's shape, spikes included. Always keeps the first and last sample.
+function downsampleIndices(xs, ys, threshold) {
+  var n = xs.length;
+  var kept = [];
+  var i, j;
+
+  threshold = Math.max(threshold, 3);
+  if (n <= threshold) {
+    for (i = 0; i < n; i++) kept.push(i);
+    return kept;
+  }
+
+  var bucketSize = (n - 2) / (threshold - 2);
+  var previous = 0;
+  kept.push(0);
+
+  for (i = 0; i < threshold - 2; i++) {
+    // Average of the next bucket is the third triangle vertex
+    var nextStart = Math.floor((i + 1) * bucketSize) + 1;
+    var nextEnd = Math.min(Math.floor((i + 2) * bucketSize) + 1, n);
+    var avgX = 0;
+    var avgY = 0;
+    for (j = nextStart; j < nextEnd; j++) {
+      avgX += xs[j];
+      avgY += ys[j];
+    }
+    avgX /= nextEnd - nextStart;
+    avgY /= nextEnd - nextStart;
+
+    // Keep the point of this bucket spanning the largest triangle with its neighbours
+    var start = Math.floor(i * bucketSize) + 1;
+    var end = Math.floor((i + 1) * bucketSize) + 1;
+    var best = start;
+    var bestArea = -1;
+    for (j = start; j < end; j++) {
+      var area = Math.abs((xs[previous] - avgX) * (ys[j] - ys[previous]) -
+                          (xs[previous] - xs[j]) * (avgY - ys[previous]));
+      if (area > bestArea) {
+        bestArea = area;
+        best = j;
+      }
+    }
+
+    kept.push(best);
+    previous = best;
   }
 
-  sendNext();
+  kept.push(n - 1);
+  return kept;
+}
+
+// Indices of the samples to show. LTTB buckets depend on the sample count, so re-downsampling a
+// grown history moves earlier picks and the watch's copy no longer lines up for a delta. When
+// every step in `sentSteps` is still among the samples and there's room, those picks are kept
+// and only the samples after them are downsampled, at the same density. Otherwise the whole
+// history is downsampled, leaving HISTORY_APPEND_HEADROOM free for later appends.
+function keptHistoryIndices(xs, ys, points, sentSteps) {
+  var i;
+  var tail = appendedHistoryIndices(xs, ys, points, sentSteps);
+  if (tail) return tail;
+
+  var all = [];
+  if (xs.length <= points) {
+    for (i = 0; i < xs.length; i++) all.push(i);
+    return all;
+  }
+  return downsampleIndices(xs, ys, Math.max(Math.floor(points * (1 - HISTORY_APPEND_HEADROOM)), 3));
+}
+
+// `sentSteps` picks plus the downsampled samples after them, or null when they can't be kept
+function appendedHistoryIndices(xs, ys, points, sentSteps) {
+  if (!sentSteps || sentSteps.length < 2 || sentSteps.length > points) return null;
+
+  var indexOfStep = {};
+  xs.forEach(function (step, i) { indexOfStep[step] = i; });
+  var kept = [];
+  for (var i = 0; i < sentSteps.length; i++) {
+    if (!(sentSteps[i] in indexOfStep)) return null;
+    kept.push(indexOfStep[sentSteps[i]]);
+  }
+
+  var anchor = kept[kept.length - 1];
+  var tailCount = xs.length - 1 - anchor;
+  if (tailCount === 0) return kept;
+
+  // As many new picks as the held ones' step spacing gives the new span
+  var spacing = (xs[anchor] - xs[kept[0]]) / (kept.length - 1);
+  var wanted = Math.max(1, Math.round((xs[xs.length - 1] - xs[anchor]) / Math.max(spacing, 1)));
+  var picks = Math.min(wanted, tailCount);
+  if (kept.length + picks > points) return null;
+
+  if (picks === tailCount) {
+    for (var j = anchor + 1; j < xs.length; j++) kept.push(j);
+  } else if (picks === 1) {
+    kept.push(xs.length - 1);
+  } else {
+    // The held last pick anchors the first triangle; LTTB keeps it, so it's skipped here
+    var tailPicks = downsampleIndices(xs.slice(anchor), ys.slice(anchor), picks + 1);
+    tailPicks.slice(1).forEach(function (k) { kept.push(anchor + k); });
+  }
+  return kept;
 }
 
 function toFixedPoint(value) {
   return Math.round(value * 10000);
 }
 
+// Fixed point rounded to `decimals` places, so the watch's truncating formatter shows what
+// toFixed(decimals) does
+function toDisplayFixedPoint(value, decimals) {
+  var unit = Math.pow(10, 4 - decimals);
+  return Math.round(value * Math.pow(10, decimals)) * unit;
+}
+
 function packInt64Array(values) {
   var buffer = new ArrayBuffer(values.length * 8);
   var view = new DataView(buffer);
@@ -361,62 +1013,828 @@ function packInt64Array(values) {
   return result;
 }
 
-// Send a single metric to the watch
-function sendMetricToWatch(metric, metricIndex, totalCount) {
-  var message = {
-    'METRIC_NAME': metric.name,
-    'METRIC_VALUE': metric.value,
-    'METRIC_INDEX': metricIndex,
-    'METRICS_COUNT': totalCount
-  };
+function packVarintDeltas(values) {
+  var result = [];
+  var previous = 0;
+  for (var i = 0; i < values.length; i++) {
+    var delta = values[i] - previous;
+    var zigzag = delta >= 0 ? delta * 2 : -delta * 2 - 1;
+    while (zigzag >= 128) {
+      result.push((zigzag % 128) | 128);
+      zigzag = Math.floor(zigzag / 128);
+    }
+    result.push(zigzag);
+    previous = values[i];
+  }
+  return result;
+}
 
-  if (metric.history && metric.history.length > 0) {
-    message['METRIC_HISTORY'] = packInt64Array(metric.history);
+function packQuantized(values, min, max, levels) {
+  var result = packInt64Array([min, max]);
+  var range = max - min;
+  for (var i = 0; i < values.length; i++) {
+    var q = range > 0 ? Math.round((values[i] - min) * levels / range) : 0;
+    result.push(q & 0xFF);
+    if (levels > 255) result.push(q >> 8);
+  }
+  return result;
+}
+
+// Fixed-point resolution the watch displays a value with `decimals` places at (4 = 1 unit)
+function displayResolution(decimals) {
+  return Math.pow(10, Math.max(0, 4 - (decimals || 0)));
+}
+
+// METRIC_VALUE payload: decimal places, then the int64 fixed-point value; METRIC_VALUE_NONE alone
+// when the run has no summary value
+function encodeValue(metric) {
+  if (metric.fixed === null || metric.fixed === undefined) return [METRIC_VALUE_NONE];
+  return [metric.decimals].concat(packInt64Array([metric.fixed]));
+}
+
+// Encode history in the smallest format whose quantization error stays below the display
+// resolution: quantized samples when the range allows it, otherwise lossless varint deltas
+function encodeHistory(values, decimals) {
+  var min = Math.min.apply(null, values);
+  var max = Math.max.apply(null, values);
+  var resolution = displayResolution(decimals);
+  var candidates = [[HISTORY_FORMAT_VARINT].concat(packVarintDeltas(values))];
+
+  if ((max - min) / 255 <= resolution) {
+    candidates.push([HISTORY_FORMAT_Q8].concat(packQuantized(values, min, max, 255)));
+  } else if ((max - min) / 65535 <= resolution) {
+    candidates.push([HISTORY_FORMAT_Q16].concat(packQuantized(values, min, max, 65535)));
+  }
+  candidates.push([HISTORY_FORMAT_INT64].concat(packInt64Array(values)));
+
+  return candidates.reduce(function (best, encoded) {
+    return encoded.length < best.length ? encoded : best;
+  });
+}
+
+function utf8Length(str) {
+  return unescape(encodeURIComponent(str)).length;
+}
+
+// Serialized tuple size: 7-byte header (key, type, length) plus payload
+function tupleSize(value) {
+  if (typeof value === 'string') return 7 + utf8Length(value) + 1;
+  if (typeof value === 'number') return 7 + 4;
+  return 7 + value.length;
+}
+
+// Find how `steps` continues the window last sent: points dropped from the front and the
+// offset of the first new point. Returns null when the sample window moved (full resync needed).
+function historyOverlap(sentSteps, steps) {
+  if (!sentSteps || sentSteps.length === 0 || steps.length === 0) return null;
+
+  var drop = sentSteps.indexOf(steps[0]);
+  if (drop === -1) return null;
+
+  var kept = sentSteps.length - drop;
+  if (steps.length < kept) return null;
+  for (var i = 0; i < kept; i++) {
+    if (sentSteps[drop + i] !== steps[i]) return null;
+  }
+
+  return { drop: drop, start: kept };
+}
+
+// Build the [key, value] tuples for one metric entry; `delta` sends only new history points
+function metricEntryTuples(metric, metricIndex, delta) {
+  var tuples = [[keys.METRIC_INDEX, metricIndex], [keys.METRIC_VALUE, encodeValue(metric)]];
+  var history = metric.history || [];
+
+  if (metric.steps && metric.steps.length > 0) {
+    tuples.push([keys.METRIC_LAST_STEP, metric.steps[metric.steps.length - 1]]);
+  }
+
+  if (delta) {
+    tuples.push([keys.METRIC_HISTORY_DROP, delta.drop]);
+    history = history.slice(delta.start);
+  } else {
+    tuples.push([keys.METRIC_NAME, metric.name]);
   }
 
-  Pebble.sendAppMessage(message, function () {
-    console.log('Sent metric ' + metricIndex + ': ' + metric.name);
+  if (history.length > 0) {
+    tuples.push([keys.METRIC_HISTORY, encodeHistory(history, metric.decimals)]);
+  }
+  return tuples;
+}
+
+// Outbound AppMessage pipeline: a FIFO with one message in flight, NACKs retried with jittered
+// exponential backoff. Items are { key, message, label } or metric entries, which are packed
+// into batches when they reach the head of the queue. A newer item replaces a queued one with
+// the same key, so a fresh value for a metric index supersedes an older one not yet sent.
+var outbox = {
+  queue: [],
+  inFlight: false,
+  maxDepth: 0
+};
+
+function outboxDepth() {
+  return outbox.queue.length + (outbox.inFlight ? 1 : 0);
+}
+
+function queueMessage(item) {
+  for (var i = 0; i < outbox.queue.length; i++) {
+    if (outbox.queue[i].key === item.key) {
+      outbox.queue[i] = item;
+      return pumpOutbox();
+    }
+  }
+
+  outbox.queue.push(item);
+  if (outboxDepth() > outbox.maxDepth) {
+    outbox.maxDepth = outboxDepth();
+    console.log('Outbound queue depth: ' + outbox.maxDepth);
+  }
+  pumpOutbox();
+}
+
+// Remove queued (not in-flight) items whose key starts with `prefix`
+function dropQueuedMessages(prefix) {
+  outbox.queue = outbox.queue.filter(function (item) {
+    return item.key.indexOf(prefix) !== 0;
+  });
+}
+
+// The watch has moved to `runKey`; metrics still queued for other runs would only be dropped there
+function dropQueuedMetricsExcept(runKey) {
+  outbox.queue = outbox.queue.filter(function (item) {
+    return item.key.indexOf('metric:') !== 0 || item.runKey === runKey;
+  });
+}
+
+// Resolve an entry's history delta against what was last sent for its metric
+function entryDelta(entry) {
+  var sentSteps = sentHistorySteps[entry.historyKey];
+  var watchHasBase = entry.baseStep !== undefined && sentSteps &&
+    sentSteps[sentSteps.length - 1] === entry.baseStep;
+  return watchHasBase ? historyOverlap(sentSteps, entry.metric.steps) : null;
+}
+
+// Pack the metric entry at the head of the queue, plus any following entries for the same
+// run that fit in the watch's inbox, into one message. The run's list index goes with it, at
+// send time, so the watch can drop a batch for a run it has since left.
+function takeMetricBatch() {
+  var head = outbox.queue[0];
+  var budget = head.inboxSize || DEFAULT_INBOX_SIZE;
+  var message = {};
+  var runIndex = runIndexOf(head.runKey);
+  var size = 1 + tupleSize(head.totalCount) + tupleSize(runIndex);
+  var slot = 0;
+  var historyKeys = [];
+
+  message[keys.METRICS_COUNT] = head.totalCount;
+  message[keys.RUN_INDEX] = runIndex;
+
+  while (outbox.queue.length > 0 && slot < METRIC_BATCH_MAX) {
+    var entry = outbox.queue[0];
+    if (!entry.metric || entry.runKey !== head.runKey) break;
+
+    var tuples = metricEntryTuples(entry.metric, entry.index, entryDelta(entry));
+    var entrySize = tuples.reduce(function (sum, tuple) { return sum + tupleSize(tuple[1]); }, 0);
+    if (slot > 0 && size + entrySize > budget) break;
+
+    tuples.forEach(function (tuple) {
+      message[tuple[0] + slot] = tuple[1];
+    });
+    sentHistorySteps[entry.historyKey] = entry.metric.steps;
+    sentPayloadHashes[entry.historyKey] = payloadHash(entry.metric);
+    historyKeys.push(entry.historyKey);
+    outbox.queue.shift();
+    size += entrySize;
+    slot++;
+  }
+
+  return { message: message, label: 'metric batch of ' + slot, historyKeys: historyKeys };
+}
+
+// The watch may not hold what we tried to send: send those metrics in full next time, and stop
+// pushing until it subscribes again (it does on reconnect)
+function forgetSentMetrics(historyKeys) {
+  historyKeys.forEach(function (historyKey) {
+    delete sentHistorySteps[historyKey];
+    delete sentPayloadHashes[historyKey];
+  });
+  setSubscription(null);
+}
+
+function pumpOutbox() {
+  if (outbox.inFlight || outbox.queue.length === 0) return;
+
+  var item = outbox.queue[0].metric ? takeMetricBatch() : outbox.queue.shift();
+  sendOutboxItem(item, 1);
+}
+
+// The Bluetooth hop, traced like a W&B request: first attempt to ACK, retries included
+function traceAppMessage(item, attempt, error) {
+  var bytes = 1;
+  for (var key in item.message) bytes += tupleSize(item.message[key]);
+  traceRecord({
+    op: 'AppMessage',
+    ms: Date.now() - item.sentAt,
+    firstByteMs: null,
+    bytes: bytes,
+    attempts: attempt,
+    error: error
+  });
+}
+
+function sendOutboxItem(item, attempt) {
+  outbox.inFlight = true;
+  if (attempt === 1) item.sentAt = Date.now();
+
+  Pebble.sendAppMessage(item.message, function () {
+    traceAppMessage(item, attempt, null);
+    outbox.inFlight = false;
+    pumpOutbox();
   }, function (err) {
-    console.log('Failed to send metric ' + metricIndex + ': ' + JSON.stringify(err));
+    if (attempt >= SEND_MAX_ATTEMPTS) {
+      console.log('Giving up on ' + item.label + ': ' + JSON.stringify(err));
+      traceAppMessage(item, attempt, 'NACK');
+      outbox.inFlight = false;
+      if (item.historyKeys) forgetSentMetrics(item.historyKeys);
+      return pumpOutbox();
+    }
+
+    var delay = SEND_RETRY_BASE_MS * Math.pow(2, attempt - 1) * (0.5 + Math.random());
+    console.log('Failed to send ' + item.label + ', retrying in ' + Math.round(delay) + 'ms');
+    setTimeout(function () {
+      sendOutboxItem(item, attempt + 1);
+    }, delay);
+  });
+}
+
+// Queue metrics for the watch; `baseStep` is the last _step the watch holds for `baseIndex`
+function sendMetricsToWatch(entries, runKey, totalCount, inboxSize, baseIndex, baseStep) {
+  entries.forEach(function (entry) {
+    queueMessage({
+      key: 'metric:' + runKey + ':' + entry.index,
+      runKey: runKey,
+      index: entry.index,
+      metric: entry.metric,
+      historyKey: runKey + '/' + entry.metric.name,
+      baseStep: entry.index === baseIndex ? baseStep : undefined,
+      totalCount: totalCount,
+      inboxSize: inboxSize
+    });
+  });
+}
+
+function djb2(str) {
+  var hash = 5381;
+  for (var i = 0; i < str.length; i++) {
+    hash = ((hash << 5) + hash + str.charCodeAt(i)) | 0;
+  }
+  return hash;
+}
+
+// Hash of what the watch displays, so unchanged polls can be skipped without keeping payloads
+function payloadHash(metric) {
+  return djb2(metric.value + '|' + metric.history.join(','));
+}
+
+function refreshIntervalMs() {
+  return parseInt(config.refreshInterval, 10) || DEFAULT_REFRESH_INTERVAL_MS;
+}
+
+function lastStep(metric) {
+  return metric.steps && metric.steps.length > 0 ? metric.steps[metric.steps.length - 1] : undefined;
+}
+
+function sameMetric(a, b) {
+  return !!a && !!b && a.value === b.value && a.steps.join(',') === b.steps.join(',');
+}
+
+// Live runs are revalidated at half the watch's refresh interval, so each refresh sees new data
+function isMetricCacheFresh(entry, runState) {
+  if (TERMINAL_RUN_STATES.indexOf(runState) !== -1) return true;
+  var ttl = refreshIntervalMs() / 2;
+  return Date.now() - entry.fetchedAt < ttl;
+}
+
+// Cached histories are downsampled for one watch display, so the point count is part of the key
+function metricCacheKey(runKey, name, points) {
+  return runKey + '/' + points + '/' + name;
+}
+
+function storeCachedMetric(key, metric) {
+  metricCache[key] = { metric: metric, fetchedAt: Date.now() };
+
+  var cacheKeys = Object.keys(metricCache);
+  if (cacheKeys.length <= METRIC_CACHE_MAX_ENTRIES) return;
+
+  // Evict the oldest entry
+  var oldest = cacheKeys.reduce(function (a, b) {
+    return metricCache[a].fetchedAt <= metricCache[b].fetchedAt ? a : b;
   });
+  delete metricCache[oldest];
 }
 
-// Fetch and send a metric by index (uses cached names if available)
-function fetchAndSendMetric(runInfo, metricIndex) {
+// Fetch and send a range of metrics by index (uses cached names if available).
+// `baseStep` is the last _step the watch holds for `firstIndex`, enabling a history delta.
+function fetchAndSendMetrics(runInfo, firstIndex, count, inboxSize, baseStep, historyPoints) {
   var runKey = runInfo.entity + '/' + runInfo.project + '/' + runInfo.run.name;
 
+  function send(entries, totalCount) {
+    sendMetricsToWatch(entries, runKey, totalCount, inboxSize, firstIndex, baseStep);
+  }
+
   function doFetch(names) {
-    if (metricIndex >= names.length) {
-      console.log('Metric index ' + metricIndex + ' out of bounds (total: ' + names.length + ')');
+    var endIndex = Math.min(firstIndex + count, names.length);
+    if (firstIndex >= endIndex) {
+      console.log('Metric index ' + firstIndex + ' out of bounds (total: ' + names.length + ')');
       return;
     }
 
-    var metricName = names[metricIndex];
-    client.fetchSingleMetric(runInfo.entity, runInfo.project, runInfo.run.name, metricName, function(err, metric) {
+    // Serve cached values right away; fetch what's missing or stale
+    var immediate = [];
+    var sentFromCache = {};
+    var toFetch = [];
+
+    for (var i = firstIndex; i < endIndex; i++) {
+      var cached = metricCache[metricCacheKey(runKey, names[i], historyPoints)];
+      var fresh = cached && isMetricCacheFresh(cached, runInfo.run.state);
+      if (!fresh) toFetch.push(i);
+      if (!cached) continue;
+
+      // A refresh of what the watch already shows only needs the revalidated value
+      var watchHolds = i === firstIndex && baseStep !== undefined && lastStep(cached.metric) === baseStep;
+      if (fresh || !watchHolds) {
+        immediate.push({ index: i, metric: cached.metric });
+        sentFromCache[i] = cached.metric;
+      }
+    }
+
+    if (immediate.length > 0) {
+      send(immediate, names.length);
+    }
+    if (toFetch.length === 0) return;
+
+    // Spare room in the last query goes to uncached neighbours, nearest first. They are only
+    // cached, so the next page flips are served without a query.
+    function needsFetch(index) {
+      var entry = metricCache[metricCacheKey(runKey, names[index], historyPoints)];
+      return !entry || !isMetricCacheFresh(entry, runInfo.run.state);
+    }
+    for (var n = 1; toFetch.length % METRIC_FETCH_WINDOW !== 0; n++) {
+      var after = endIndex - 1 + n;
+      var before = firstIndex - n;
+      if (after >= names.length && before < 0) break;
+      if (after < names.length && needsFetch(after)) toFetch.push(after);
+      if (before >= 0 && toFetch.length % METRIC_FETCH_WINDOW !== 0 && needsFetch(before)) toFetch.push(before);
+    }
+
+    // Fetch a window per query, then send the requested range as one batch in index order
+    var chunks = metricFetchChunks(toFetch);
+    var results = [];
+    var pending = chunks.length;
+
+    chunks.forEach(function (chunk) {
+      var chunkNames = chunk.map(function (metricIndex) { return names[metricIndex]; });
+      client.fetchRunMetrics(runInfo.entity, runInfo.project, runInfo.run.name, chunkNames, historyPoints, function(err, metrics) {
+        if (err) {
+          console.log('Error fetching metrics ' + chunk.join(',') + ': ' + JSON.stringify(err));
+        } else {
+          metrics.forEach(function (metric, k) {
+            var metricIndex = chunk[k];
+            storeCachedMetric(metricCacheKey(runKey, metric.name, historyPoints), metric);
+            if (metricIndex < firstIndex || metricIndex >= endIndex) return;
+            // Stale copy already on its way and nothing changed: no need to send it again
+            if (!sameMetric(sentFromCache[metricIndex], metric)) {
+              results.push({ index: metricIndex, metric: metric });
+            }
+          });
+        }
+
+        pending--;
+        if (pending > 0 || results.length === 0) return;
+        results.sort(function (a, b) { return a.index - b.index; });
+        send(results, names.length);
+      });
+    });
+  }
+
+  withMetricNames(runInfo, doFetch);
+}
+
+// Warm the caches for a run highlighted in the watch's menu: its names, then the first window
+// of metrics opening it fetches. Nothing is sent; opening the run is then served from the
+// caches, or joins the same queries while they are still in flight.
+function prefetchRun(runInfo, historyPoints) {
+  var runKey = runKeyOf(runInfo);
+
+  withMetricNames(runInfo, function (names) {
+    var first = names.slice(0, METRIC_FETCH_WINDOW);
+    var missing = first.some(function (name) {
+      var entry = metricCache[metricCacheKey(runKey, name, historyPoints)];
+      return !entry || !isMetricCacheFresh(entry, runInfo.run.state);
+    });
+    if (!missing) return;
+
+    client.fetchRunMetrics(runInfo.entity, runInfo.project, runInfo.run.name, first, historyPoints, function (err, metrics) {
       if (err) {
-        console.log('Error fetching metric: ' + JSON.stringify(err));
+        console.log('Error prefetching ' + runKey + ': ' + JSON.stringify(err));
         return;
       }
-      sendMetricToWatch(metric, metricIndex, names.length);
+      metrics.forEach(function (metric) {
+        storeCachedMetric(metricCacheKey(runKey, metric.name, historyPoints), metric);
+      });
     });
+  });
+}
+
+// Keep a run's names in localStorage, dropping the oldest runs past METRIC_NAMES_STORE_MAX_RUNS
+function storeMetricNames(runKey, names) {
+  storedMetricNames[runKey] = { names: names, savedAt: Date.now() };
+
+  var runKeys = Object.keys(storedMetricNames);
+  runKeys.sort(function (a, b) { return storedMetricNames[b].savedAt - storedMetricNames[a].savedAt; });
+  runKeys.slice(METRIC_NAMES_STORE_MAX_RUNS).forEach(function (key) { delete storedMetricNames[key]; });
+  saveStored('metricNames', storedMetricNames);
+}
+
+// A run's cached names, marking them used
+function cachedNamesFor(runKey) {
+  var entry = cachedMetricNames[runKey];
+  if (!entry) return null;
+  entry.usedAt = Date.now();
+  return entry.names;
+}
+
+// Names stay put for the subscribed run: the watch holds its metrics by index
+function cacheMetricNames(runKey, names) {
+  cachedMetricNames[runKey] = { names: names, usedAt: Date.now() };
+
+  var runKeys = Object.keys(cachedMetricNames).filter(function (key) {
+    return !subscription || key !== subscription.runKey;
+  });
+  if (runKeys.length <= METRIC_NAMES_CACHE_MAX_RUNS) return;
+  var oldest = runKeys.reduce(function (a, b) {
+    return cachedMetricNames[a].usedAt <= cachedMetricNames[b].usedAt ? a : b;
+  });
+  delete cachedMetricNames[oldest];
+}
+
+function isStoredNamesFresh(entry, runState) {
+  if (TERMINAL_RUN_STATES.indexOf(runState) !== -1) return true;
+  return Date.now() - entry.savedAt < METRIC_NAMES_STORE_TTL_MS;
+}
+
+// Call back with the run's sorted metric names, fetching them unless cached or stored
+function withMetricNames(runInfo, callback) {
+  var runKey = runInfo.entity + '/' + runInfo.project + '/' + runInfo.run.name;
+  var cached = cachedNamesFor(runKey);
+  if (cached) return callback(cached);
+
+  var stored = storedMetricNames[runKey];
+  if (stored && isStoredNamesFresh(stored, runInfo.run.state)) {
+    cacheMetricNames(runKey, stored.names);
+    return callback(stored.names);
   }
 
-  // Check if we have cached names for this run
-  if (cachedMetricNames.runKey === runKey) {
-    doFetch(cachedMetricNames.names);
-  } else {
-    // Need to fetch names first
-    client.fetchMetricNames(runInfo.entity, runInfo.project, runInfo.run.name, function(err, names) {
+  client.fetchMetricNames(runInfo.entity, runInfo.project, runInfo.run.name, function(err, names) {
+    if (err) {
+      console.log('Error fetching metric names: ' + JSON.stringify(err));
+      return;
+    }
+    // Cache the names
+    cacheMetricNames(runKey, names);
+    storeMetricNames(runKey, names);
+    callback(names);
+  });
+}
+
+// UTF-8 bytes of `str`, cut to at most `maxBytes` without splitting a character
+function utf8Bytes(str, maxBytes) {
+  var binary = unescape(encodeURIComponent(str));
+  var length = Math.min(binary.length, maxBytes);
+  while (length < binary.length && length > 0 && (binary.charCodeAt(length) & 0xC0) === 0x80) length--;
+
+  var bytes = [];
+  for (var i = 0; i < length; i++) bytes.push(binary.charCodeAt(i));
+  return bytes;
+}
+
+// One overview tile: name length + bytes, value length + bytes, point count, then the
+// sparkline as 4-bit levels over the history's own range, two per byte, high nibble first
+function packOverviewTile(metric) {
+  var name = utf8Bytes(metric.name, OVERVIEW_NAME_BYTES);
+  var value = utf8Bytes(metric.value, OVERVIEW_VALUE_BYTES);
+  var history = metric.history;
+  var min = Math.min.apply(null, history);
+  var max = Math.max.apply(null, history);
+  var range = max - min || 1;
+
+  var bytes = [name.length].concat(name, [value.length], value, [history.length]);
+  for (var i = 0; i < history.length; i += 2) {
+    var high = Math.round((history[i] - min) / range * OVERVIEW_SPARK_LEVELS);
+    var low = i + 1 < history.length ? Math.round((history[i + 1] - min) / range * OVERVIEW_SPARK_LEVELS) : 0;
+    bytes.push((high << 4) | low);
+  }
+  return bytes;
+}
+
+// Send tiles for the first `maxTiles` metrics of a run, packed into as few messages as fit
+// the watch's inbox. Metrics are fetched at sparkline resolution, a window per query.
+function sendOverview(runInfo, maxTiles, inboxSize) {
+  var runKey = runInfo.entity + '/' + runInfo.project + '/' + runInfo.run.name;
+
+  withMetricNames(runInfo, function (names) {
+    var count = Math.min(names.length, maxTiles);
+    var metrics = [];
+    var toFetch = [];
+
+    for (var i = 0; i < count; i++) {
+      var cached = metricCache[metricCacheKey(runKey, names[i], OVERVIEW_SPARK_POINTS)];
+      if (cached && isMetricCacheFresh(cached, runInfo.run.state)) {
+        metrics[i] = cached.metric;
+      } else {
+        toFetch.push(i);
+      }
+    }
+
+    function sendTiles() {
+      dropQueuedMessages('overview:');
+      var budget = (inboxSize || DEFAULT_INBOX_SIZE) - 1 - tupleSize(count) - tupleSize(0) - tupleSize([]);
+      var first = 0;
+      var data = [];
+
+      function flush(next) {
+        var message = { 'OVERVIEW_COUNT': count, 'OVERVIEW_FIRST': first, 'OVERVIEW_DATA': data };
+        queueMessage({ key: 'overview:' + first, message: message, label: 'overview from ' + first });
+        first = next;
+        data = [];
+      }
+
+      for (var t = 0; t < count; t++) {
+        // A failed fetch still takes its place, as a tile with no sparkline
+        var tile = packOverviewTile(metrics[t] || { name: names[t], value: '---', history: [] });
+        if (data.length > 0 && data.length + tile.length > budget) flush(t);
+        data = data.concat(tile);
+      }
+      flush(count);
+    }
+
+    var chunks = metricFetchChunks(toFetch);
+    var pending = chunks.length;
+    if (pending === 0) return sendTiles();
+
+    chunks.forEach(function (chunk) {
+      var chunkNames = chunk.map(function (metricIndex) { return names[metricIndex]; });
+      client.fetchRunMetrics(runInfo.entity, runInfo.project, runInfo.run.name, chunkNames, OVERVIEW_SPARK_POINTS, function (err, fetched) {
+        if (err) {
+          console.log('Error fetching overview metrics ' + chunk.join(',') + ': ' + JSON.stringify(err));
+        } else {
+          fetched.forEach(function (metric, k) {
+            storeCachedMetric(metricCacheKey(runKey, metric.name, OVERVIEW_SPARK_POINTS), metric);
+            metrics[chunk[k]] = metric;
+          });
+        }
+        pending--;
+        if (pending === 0) sendTiles();
+      });
+    });
+  });
+}
+
+// Call back with the run's headline metric (the first of its sorted names) at value resolution
+function fetchHeadline(runInfo, callback) {
+  var runKey = runInfo.entity + '/' + runInfo.project + '/' + runInfo.run.name;
+
+  function fetchValue(name) {
+    client.fetchRunMetrics(runInfo.entity, runInfo.project, runInfo.run.name, [name], HEADLINE_HISTORY_POINTS, function (err, fetched) {
       if (err) {
-        console.log('Error fetching metric names: ' + JSON.stringify(err));
+        console.log('Error fetching headline of ' + runKey + ': ' + JSON.stringify(err));
         return;
       }
-      // Cache the names
-      cachedMetricNames.runKey = runKey;
-      cachedMetricNames.names = names;
-      doFetch(names);
+      callback(fetched[0]);
     });
   }
+
+  if (headlineNames[runKey]) return fetchValue(headlineNames[runKey]);
+  var cached = cachedMetricNames[runKey];
+  if (cached && cached.names.length > 0) {
+    headlineNames[runKey] = cached.names[0];
+    return fetchValue(headlineNames[runKey]);
+  }
+  client.fetchMetricNames(runInfo.entity, runInfo.project, runInfo.run.name, function (err, names) {
+    if (err || !names || names.length === 0) return;
+    headlineNames[runKey] = names[0];
+    fetchValue(names[0]);
+  });
+}
+
+// A headline is republished only when its value moved by HEADLINE_MIN_CHANGE of itself
+function isHeadlineNews(published, metric) {
+  if (metric.fixed === null) return false;
+  if (!published) return true;
+  var base = Math.max(Math.abs(published.fixed), 1);
+  return metric.decimals !== published.decimals ||
+    Math.abs(metric.fixed - published.fixed) / base >= HEADLINE_MIN_CHANGE;
+}
+
+function headlineText(runInfo, metric) {
+  return metric.name + ' ' + metric.value + ' - ' + (runInfo.run.displayName || runInfo.run.name);
+}
+
+// Replace the app glance with the run's headline; braces would be read as template syntax
+function publishGlance(runInfo, metric) {
+  var slice = {
+    layout: { subtitleTemplateString: headlineText(runInfo, metric).replace(/[{}]/g, '|') },
+    expirationTime: new Date(Date.now() + HEADLINE_GLANCE_TTL_MS).toISOString()
+  };
+  Pebble.appGlanceReload([slice], function () {}, function (err) {
+    console.log('App glance update failed: ' + JSON.stringify(err));
+  });
+}
+
+// Publish a run's headline as a timeline pin, one per run, updated in place
+function pushHeadlinePin(runInfo, metric) {
+  var runKey = runInfo.entity + '/' + runInfo.project + '/' + runInfo.run.name;
+  Pebble.getTimelineToken(function (token) {
+    var pin = {
+      id: 'wandb-run-' + (djb2(runKey) >>> 0),
+      time: new Date().toISOString(),
+      layout: {
+        type: 'genericPin',
+        title: metric.name + ' ' + metric.value,
+        subtitle: runInfo.run.displayName || runInfo.run.name,
+        body: runInfo.entity + '/' + runInfo.project,
+        tinyIcon: 'system://images/NOTIFICATION_FLAG'
+      }
+    };
+
+    var xhr = new XMLHttpRequest();
+    xhr.open('PUT', TIMELINE_PIN_URL + pin.id, true);
+    xhr.setRequestHeader('Content-Type', 'application/json');
+    xhr.setRequestHeader('X-User-Token', token);
+    xhr.onload = function () {
+      if (xhr.status !== 200) console.log('Timeline pin for ' + runKey + ' failed: HTTP ' + xhr.status);
+    };
+    xhr.send(JSON.stringify(pin));
+  }, function (error) {
+    console.log('No timeline token: ' + error);
+  });
+}
+
+// Check the headline of the newest running runs and publish the ones that changed: the first
+// as the app glance, every one as a pin when enabled. Reschedules itself.
+function publishHeadlines() {
+  if (headlineTimer) clearTimeout(headlineTimer);
+  headlineTimer = setTimeout(publishHeadlines, Math.max(HEADLINE_REFRESH_MS, refreshIntervalMs()));
+
+  var running = runs.filter(function (runInfo) {
+    return runInfo.run.state === 'running';
+  }).slice(0, HEADLINE_MAX_RUNS);
+
+  running.forEach(function (runInfo, n) {
+    var runKey = runInfo.entity + '/' + runInfo.project + '/' + runInfo.run.name;
+    fetchHeadline(runInfo, function (metric) {
+      var isGlance = n === 0;
+      var news = isHeadlineNews(publishedHeadlines[runKey], metric);
+      if (!news && !(isGlance && glanceRunKey !== runKey)) return;
+
+      if (isGlance) {
+        publishGlance(runInfo, metric);
+        glanceRunKey = runKey;
+        localStorage.setItem('glanceRunKey', runKey);
+      }
+      if (news) {
+        if (config.timelinePins) pushHeadlinePin(runInfo, metric);
+        publishedHeadlines[runKey] = { fixed: metric.fixed, decimals: metric.decimals };
+        localStorage.setItem('headlines', JSON.stringify(publishedHeadlines));
+      }
+    });
+  });
+}
+
+function cancelSubscriptionPoll() {
+  if (subscriptionTimer) clearTimeout(subscriptionTimer);
+  subscriptionTimer = null;
+}
+
+// Replace the watch's push subscription; a missing run or zero count cancels it.
+// Finished runs can't change, so subscribing to one polls nothing.
+function setSubscription(runInfo, firstIndex, count, inboxSize, historyPoints) {
+  if (!runInfo || !count || TERMINAL_RUN_STATES.indexOf(runInfo.run.state) !== -1) {
+    subscription = null;
+    cancelSubscriptionPoll();
+    return;
+  }
+
+  var runKey = runInfo.entity + '/' + runInfo.project + '/' + runInfo.run.name;
+  var sameRun = !!subscription && subscription.runKey === runKey;
+  if (!sameRun) cancelSubscriptionPoll();
+
+  subscription = {
+    runKey: runKey,
+    runInfo: runInfo,
+    firstIndex: firstIndex,
+    count: count,
+    inboxSize: inboxSize,
+    historyPoints: historyPoints,
+    unchangedPolls: sameRun ? subscription.unchangedPolls : 0
+  };
+  // Keep the same run's schedule (and backoff), so scrolling doesn't postpone the next poll
+  if (!subscriptionTimer) scheduleSubscriptionPoll();
+}
+
+function scheduleSubscriptionPoll() {
+  var delay = refreshIntervalMs() * Math.pow(2, subscription.unchangedPolls);
+  subscriptionTimer = setTimeout(pollSubscription, Math.min(delay, POLL_BACKOFF_MAX_MS));
+}
+
+function isSubscribed(runKey, metricIndex) {
+  return !!subscription && subscription.runKey === runKey &&
+    metricIndex >= subscription.firstIndex && metricIndex < subscription.firstIndex + subscription.count;
+}
+
+// Refetch every subscribed metric and push only those whose displayed payload changed
+function pollSubscription() {
+  subscriptionTimer = null;
+  var sub = subscription;
+  if (!sub) return;
+
+  // Names arrive with the watch's first fetch for the run; until then there's nothing to poll
+  var names = cachedNamesFor(sub.runKey) || [];
+  var endIndex = Math.min(sub.firstIndex + sub.count, names.length);
+  var indices = [];
+  for (var i = sub.firstIndex; i < endIndex; i++) indices.push(i);
+  var chunks = metricFetchChunks(indices);
+  var pending = chunks.length;
+  var changed = false;
+
+  function onPolled(chunkChanged) {
+    changed = changed || chunkChanged;
+    pending--;
+    if (pending > 0) return;
+
+    // The subscription may have moved within the run meanwhile; it keeps the backoff
+    if (!subscription || subscription.runKey !== sub.runKey) return;
+    subscription.unchangedPolls = changed ? 0 : sub.unchangedPolls + 1;
+    if (!subscriptionTimer) scheduleSubscriptionPoll();
+  }
+
+  if (pending <= 0) {
+    scheduleSubscriptionPoll();
+    return;
+  }
+
+  chunks.forEach(function (chunk) {
+    pollSubscribedMetrics(sub, names, chunk, onPolled);
+  });
+}
+
+// Refetch a window of subscribed metrics in one query; calls back whether any changed
+function pollSubscribedMetrics(sub, names, indices, done) {
+  var runInfo = sub.runInfo;
+  var chunkNames = indices.map(function (metricIndex) { return names[metricIndex]; });
+  client.fetchRunMetrics(runInfo.entity, runInfo.project, runInfo.run.name, chunkNames, sub.historyPoints, function (err, metrics) {
+    if (err) {
+      console.log('Error polling metrics ' + indices.join(',') + ': ' + JSON.stringify(err));
+      return done(false);
+    }
+
+    var changed = false;
+    metrics.forEach(function (metric, k) {
+      var metricIndex = indices[k];
+      storeCachedMetric(metricCacheKey(sub.runKey, metric.name, sub.historyPoints), metric);
+
+      var historyKey = sub.runKey + '/' + metric.name;
+      if (payloadHash(metric) === sentPayloadHashes[historyKey]) return;
+      changed = true;
+      if (!isSubscribed(sub.runKey, metricIndex)) return;
+
+      // The watch holds what was last sent, so only the new samples need to go
+      var sentSteps = sentHistorySteps[historyKey];
+      var baseStep = sentSteps && sentSteps.length > 0 ? sentSteps[sentSteps.length - 1] : undefined;
+      sendMetricsToWatch([{ index: metricIndex, metric: metric }], sub.runKey, names.length,
+        sub.inboxSize, metricIndex, baseStep);
+    });
+    done(changed);
+  });
+}
+
+// Field order of the watch's DIAGNOSTICS export (little-endian uint32s)
+var DIAGNOSTICS_FIELDS = [
+  'requests', 'latencyMeanMs', 'latencyMinMs', 'latencyMaxMs', 'latencyLastMs',
+  'bufferHits', 'bufferMisses', 'inboxDrops', 'outboxFailures',
+  'bytesReceived', 'heapPeakBytes', 'heapUsedBytes',
+  'firstRowMs', 'openToMetricMs', 'skeletonFrames', 'bytesSent'
+];
+
+function logWatchDiagnostics(bytes) {
+  var report = {};
+  DIAGNOSTICS_FIELDS.forEach(function (name, i) {
+    var offset = i * 4;
+    if (offset + 4 > bytes.length) return;
+    report[name] = (bytes[offset] | (bytes[offset + 1] << 8) | (bytes[offset + 2] << 16)) +
+      bytes[offset + 3] * 0x1000000;
+  });
+  console.log('Watch diagnostics: ' + JSON.stringify(report));
 }
 
 Pebble.addEventListener('ready', function () {
@@ -427,25 +1845,96 @@ Pebble.addEventListener('ready', function () {
     return;
   }
 
-  client.fetchAllRuns(function (err, fetchedRuns) {
+  if (headlineTimer) clearTimeout(headlineTimer);
+  headlineTimer = setTimeout(publishHeadlines, HEADLINE_FIRST_DELAY_MS);
+
+  // Answer from the last session's list right away; the refresh patches whatever changed
+  var stored = loadStoredRuns();
+  if (stored) {
+    console.log('Sending ' + stored.runs.length + ' stored runs, saved ' +
+      Math.round((Date.now() - stored.savedAt) / 1000) + ' s ago');
+    runs = stored.runs;
+    runCursors = stored.cursors || [];
+    sendRunsToWatch(0, RUNS_FIRST_PAGE_SIZE, false, false);
+    refreshRunsList();
+    return;
+  }
+
+  client.fetchAllRuns(function (err, page) {
     if (err) {
       console.log('Error fetching runs: ' + JSON.stringify(err));
       return;
     }
 
-    console.log('Fetched ' + fetchedRuns.length + ' runs');
-    runs = fetchedRuns;
-    sendRunsToWatch(runs);
+    console.log('Fetched ' + page.runs.length + ' runs');
+    runs = sortRuns(page.runs);
+    runCursors = page.cursors;
+    saveRuns();
+    sendRunsToWatch(0, RUNS_FIRST_PAGE_SIZE, false, false);
+    scheduleRunsRefresh();
   });
 });
 
 Pebble.addEventListener('appmessage', function (e) {
+  if (e.payload['DIAGNOSTICS']) {
+    logWatchDiagnostics(e.payload['DIAGNOSTICS']);
+    console.log('Request trace: ' + JSON.stringify({ stats: traceStats, recent: traceRecent }));
+    return;
+  }
+
+  if (e.payload['FETCH_TRACE']) {
+    queueMessage({ key: 'trace', message: { 'TRACE_SUMMARY': traceSummary(TRACE_SUMMARY_MAX_CHARS) }, label: 'trace summary' });
+    return;
+  }
+
   var runIndex = e.payload['FETCH_RUN_INDEX'];
   var metricIndex = e.payload['FETCH_METRIC_INDEX'];
+  var metricCount = e.payload['FETCH_METRIC_COUNT'] || 1;
+  var inboxSize = e.payload['FETCH_INBOX_SIZE'];
+  var baseStep = e.payload['FETCH_BASE_STEP'];
+  var historyPoints = e.payload['FETCH_HISTORY_POINTS'] || DEFAULT_HISTORY_POINTS;
+
+  var overviewRun = e.payload['FETCH_OVERVIEW_RUN'];
+  if (overviewRun !== undefined && overviewRun !== null) {
+    if (runs[overviewRun]) sendOverview(runs[overviewRun], metricCount, inboxSize);
+    return;
+  }
+
+  var prefetchRunIndex = e.payload['PREFETCH_RUN_INDEX'];
+  if (prefetchRunIndex !== undefined && prefetchRunIndex !== null) {
+    if (runs[prefetchRunIndex]) prefetchRun(runs[prefetchRunIndex], historyPoints);
+    return;
+  }
+
+  var runsStart = e.payload['FETCH_RUNS_START'];
+  if (runsStart !== undefined && runsStart !== null) {
+    if (e.payload['FETCH_RUNS_BACKWARD']) {
+      var pageStart = Math.max(0, runsStart - RUNS_PAGE_SIZE);
+      sendRunsToWatch(pageStart, runsStart - pageStart, true, true);
+    } else {
+      ensureRunsLoaded(runsStart + RUNS_PAGE_SIZE, function () {
+        sendRunsToWatch(runsStart, RUNS_PAGE_SIZE, true, false);
+      });
+    }
+    return;
+  }
+
+  var subscribeRunIndex = e.payload['SUBSCRIBE_RUN_INDEX'];
+  if (subscribeRunIndex !== undefined && subscribeRunIndex !== null) {
+    if (runs[subscribeRunIndex]) dropQueuedMetricsExcept(runKeyOf(runs[subscribeRunIndex]));
+    setSubscription(runs[subscribeRunIndex], e.payload['SUBSCRIBE_METRIC_INDEX'] || 0,
+      e.payload['SUBSCRIBE_METRIC_COUNT'] || 0, inboxSize, historyPoints);
+  }
 
   if (runIndex !== undefined && runIndex !== null && metricIndex !== undefined && metricIndex !== null) {
     var runInfo = runs[runIndex];
-    console.log('Fetching metric ' + metricIndex + ' for run ' + runIndex);
-    fetchAndSendMetric(runInfo, metricIndex);
+    if (!runInfo) {
+      // Watch is showing its cached runs list; it re-requests once ours arrives
+      console.log('Ignoring fetch for run ' + runIndex + ' before runs are loaded');
+      return;
+    }
+    console.log('Fetching metrics ' + metricIndex + '-' + (metricIndex + metricCount - 1) + ' for run ' + runIndex);
+    dropQueuedMetricsExcept(runKeyOf(runInfo));
+    fetchAndSendMetrics(runInfo, metricIndex, metricCount, inboxSize, baseStep, historyPoints);
   }
 });